@@ -19,10 +19,14 @@ ATMOS_API uint32_t atmos_get_version();
 ATMOS_API uint32_t atmos_get_simd_level();
 
 ATMOS_API GridAtmosState* atmos_create_grid(int32_t initialCapacity);
+ATMOS_API GridAtmosState* atmos_create_grid_ex(int32_t initialCapacity, int32_t gasCount);
 ATMOS_API void atmos_destroy_grid(GridAtmosState* state);
 ATMOS_API void atmos_reset_grid(GridAtmosState* state);
 
 ATMOS_API int32_t atmos_add_tile(GridAtmosState* state, const TileAtmosData* tile);
+ATMOS_API int32_t atmos_add_tiles(GridAtmosState* state, const TileAtmosData* tiles, int32_t count, int32_t* outIndices, uint8_t buildAdjacency);
+ATMOS_API void atmos_build_adjacency(GridAtmosState* state);
+ATMOS_API int32_t atmos_optimize_layout(GridAtmosState* state, int32_t* outRemap);
 ATMOS_API void atmos_update_tile(GridAtmosState* state, int32_t index, const TileAtmosData* tile);
 ATMOS_API TileAtmosData* atmos_get_tile(GridAtmosState* state, int32_t index);
 ATMOS_API void atmos_set_adjacency(GridAtmosState* state, int32_t tileIndex, int32_t direction, int32_t adjacentIndex);
@@ -31,6 +35,18 @@ ATMOS_API void atmos_add_active_tile(GridAtmosState* state, int32_t tileIndex);
 ATMOS_API void atmos_remove_active_tile(GridAtmosState* state, int32_t tileIndex);
 
 ATMOS_API AtmosResult atmos_process(GridAtmosState* state, const AtmosConfig* config);
+// Ticks each distinct grid once; repeated pointers share the first occurrence's result.
+// Grids are spread across the worker pool whole. A single large grid is only split
+// further when config->parallelLindaEnabled is set.
+ATMOS_API void atmos_process_many(GridAtmosState** grids, int32_t count, const AtmosConfig* config, AtmosResult* results);
+// The shared worker pool starts on first use with one thread per hardware thread. This
+// resizes it; 0 selects that default again. Call between ticks, not per tick: returns 0 and
+// leaves the pool as it is while a tick is running on it, 1 otherwise.
+ATMOS_API int32_t atmos_set_worker_threads(int32_t threads);
+ATMOS_API int32_t atmos_get_worker_threads(void);
+// Joins the worker threads. Call before unloading the library; the next parallel tick starts
+// them again at the configured size.
+ATMOS_API void atmos_shutdown(void);
 
 ATMOS_API AtmosResult atmos_process_revalidate(GridAtmosState* state, const AtmosConfig* config);
 ATMOS_API AtmosResult atmos_process_active_tiles(GridAtmosState* state, const AtmosConfig* config);
@@ -38,6 +54,7 @@ ATMOS_API AtmosResult atmos_process_excited_groups(GridAtmosState* state, const
 ATMOS_API AtmosResult atmos_process_hotspots(GridAtmosState* state, const AtmosConfig* config);
 ATMOS_API AtmosResult atmos_process_superconductivity(GridAtmosState* state, const AtmosConfig* config);
 ATMOS_API AtmosResult atmos_process_high_pressure(GridAtmosState* state, const AtmosConfig* config);
+ATMOS_API int32_t atmos_get_wind_events(const GridAtmosState* state, const AtmosWindEvent** events);
 
 ATMOS_API AtmosResult atmos_equalize_pressure_zone(GridAtmosState* state, int32_t startTile, const AtmosConfig* config);
 ATMOS_API AtmosResult atmos_explosive_depressurize(GridAtmosState* state, int32_t startTile, const AtmosConfig* config);
@@ -46,23 +63,44 @@ ATMOS_API void atmos_ignite_hotspot(GridAtmosState* state, int32_t tileIndex, fl
 ATMOS_API void atmos_extinguish_hotspot(GridAtmosState* state, int32_t tileIndex);
 
 ATMOS_API float atmos_get_heat_capacity(const TileAtmosData* tile, const float* specificHeats);
+// Archived moles and temperature are refreshed each tick only for active tiles, superconducting
+// tiles and their neighbours; on idle tiles they hold whatever was last archived.
 ATMOS_API float atmos_get_heat_capacity_archived(const TileAtmosData* tile, const float* specificHeats);
 ATMOS_API float atmos_get_thermal_energy(const TileAtmosData* tile, const float* specificHeats);
+ATMOS_API int32_t atmos_query_tiles(const GridAtmosState* state, const int32_t* tileIndices, int32_t count, const AtmosConfig* config,
+                                    float* heatCapacity, float* pressure, float* totalMoles, float* thermalEnergy);
+ATMOS_API int32_t atmos_query_grid(const GridAtmosState* state, const AtmosConfig* config,
+                                   float* heatCapacity, float* pressure, float* totalMoles, float* thermalEnergy);
 
 ATMOS_API void atmos_merge(TileAtmosData* receiver, const TileAtmosData* giver, const float* specificHeats);
 ATMOS_API void atmos_remove_gas(TileAtmosData* tile, float amount, TileAtmosData* removed);
 ATMOS_API void atmos_remove_ratio(TileAtmosData* tile, float ratio, TileAtmosData* removed);
 
 ATMOS_API int32_t atmos_react(TileAtmosData* tile, const AtmosConfig* config);
+// The reaction table is shared by every grid and read without locking, so only change it between
+// ticks. Both calls refuse while a tick is running on the worker pool (-1 and 0 respectively);
+// that check cannot see a serial tick on another thread.
+ATMOS_API int32_t atmos_register_reaction(const AtmosReactionDefinition* definition);
+ATMOS_API int32_t atmos_reset_reactions(void);
+ATMOS_API int32_t atmos_get_reaction_count(void);
 
 ATMOS_API void atmos_share(TileAtmosData* receiver, TileAtmosData* sharer, int32_t adjacentCount, const AtmosConfig* config);
 ATMOS_API float atmos_temperature_share(TileAtmosData* receiver, TileAtmosData* sharer, float conductionCoefficient, const AtmosConfig* config);
 
 ATMOS_API void atmos_config_init_default(AtmosConfig* config);
 
+ATMOS_API void atmos_get_stats(GridAtmosState* state, AtmosStats* stats, uint8_t reset);
+
 ATMOS_API int32_t atmos_get_active_tile_count(const GridAtmosState* state);
+ATMOS_API int32_t atmos_get_gas_count(const GridAtmosState* state);
 ATMOS_API int32_t atmos_get_tile_count(const GridAtmosState* state);
+// Direct view of the tile array. molesArchived/temperatureArchived are only current for tiles
+// the last tick archived (see atmos_get_heat_capacity_archived); call atmos_archive_all first
+// if every tile's archive is needed. Gas slots at or past atmos_get_gas_count must be left zero;
+// anything written there is discarded the next time the tile is archived.
 ATMOS_API TileAtmosData* atmos_get_tiles_ptr(GridAtmosState* state);
+ATMOS_API int32_t atmos_reserve_tile_storage(GridAtmosState* state, int32_t maxTiles);
+ATMOS_API uint32_t atmos_get_layout_generation(const GridAtmosState* state);
 
 ATMOS_API void atmos_archive_tile(TileAtmosData* tile);
 ATMOS_API void atmos_archive_all(GridAtmosState* state);
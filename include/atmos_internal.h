@@ -17,11 +17,165 @@
     #endif
 #endif
 
+#define LINDA_MAX_CELL_OPS 24
+#define LINDA_COLOR_COUNT 5
+#define LINDA_BATCH_GRAIN 64
+#define ATMOS_BUDGET_CHECK_INTERVAL 30
+
+#define LINDA_OP_ACTIVATE   0
+#define LINDA_OP_MERGE      1
+#define LINDA_OP_JOIN       2
+#define LINDA_OP_PRESSURE   3
+#define LINDA_OP_LAST_SHARE 4
+#define LINDA_OP_FINISH     5
+#define LINDA_OP_REACTIONS  6
+
+struct LindaCellOp
+{
+    uint8_t type;
+    uint8_t direction;
+    uint8_t padding[2];
+    int32_t tileIndex;
+    int32_t otherIndex;
+    float value;
+    float auxValue;
+};
+
+struct LindaOpLog
+{
+    LindaCellOp* ops;
+    int32_t count;
+    int32_t capacity;
+};
+
+struct LindaPassScratch
+{
+    int32_t* order;
+    uint8_t* colors;
+    int32_t orderCapacity;
+    LindaOpLog* logs;
+    int32_t logCapacity;
+    int32_t colorStart[LINDA_COLOR_COUNT + 2];
+    int32_t cursor;
+    int32_t monstermosCursor;
+};
+
+struct MonstermosZone
+{
+    int32_t startTile;
+    int32_t firstMember;
+    int32_t touchedCount;
+    int32_t memberCount;
+    int32_t progressionCount;
+    int32_t seedCount;
+    int32_t checkedCount;
+    uint64_t signature;
+};
+
+struct ZoneRecordCache
+{
+    MonstermosZone* zones;
+    int32_t zoneCount;
+    int32_t zoneCapacity;
+    int32_t* members;
+    int32_t memberCount;
+    int32_t memberCapacity;
+    int32_t* zoneOfTile;
+    int32_t tileCapacity;
+};
+
+struct CoarseBlock
+{
+    float moles[ATMOS_GAS_ARRAY_SIZE];
+    float energy;
+    float temperature;
+    float totalMoles;
+    float flow;
+    int32_t tileCount;
+    int32_t firstTile;
+    int32_t tileSpan;
+    int32_t parent;
+    int32_t linkTile;
+    int32_t linkDirection;
+};
+
+struct MonstermosScratch
+{
+    TileAtmosData** equalizeTiles;
+    TileAtmosData** giverTiles;
+    TileAtmosData** takerTiles;
+    TileAtmosData** queue;
+    TileAtmosData** depressurizeTiles;
+    TileAtmosData** spaceTiles;
+    TileAtmosData** progressionOrder;
+    TileAtmosData** sortTiles;
+    int32_t* flowRoots;
+    uint64_t* sortKeys;
+    uint64_t* sortScratch;
+    int32_t zoneCapacity;
+    int32_t queueCapacity;
+    int32_t walkCapacity;
+
+    ZoneRecordCache equalizeZones;
+    ZoneRecordCache depressurizeZones;
+    uint32_t zoneTopologyGeneration;
+    uint32_t zoneLayoutGeneration;
+    int32_t zoneTileLimit;
+    int32_t zoneHardLimit;
+
+    int32_t* coarseTiles;
+    int32_t coarseTileCapacity;
+    CoarseBlock* coarseBlocks;
+    int32_t coarseBlockCount;
+};
+
+struct AtmosBudget
+{
+    int64_t deadline;
+    int32_t sinceCheck;
+};
+
+typedef void (*AtmosJobFn)(void* context, int32_t begin, int32_t end);
+
+struct TileQueryOutputs
+{
+    float* heatCapacity;
+    float* pressure;
+    float* totalMoles;
+    float* thermalEnergy;
+};
+
+struct AtmosKernelTable
+{
+    uint32_t simdLevel;
+    float (*heatCapacity)(const float* moles, const float* specificHeats, bool space);
+    float (*heatCapacityArchived)(const TileAtmosData* tile, const float* specificHeats);
+    void (*share)(TileAtmosData* receiver, TileAtmosData* sharer, int adjacentCount, const AtmosConfig* config);
+    float (*temperatureShare)(TileAtmosData* receiver, TileAtmosData* sharer, float conductionCoefficient, const AtmosConfig* config);
+    void (*groupBreakdown)(TileAtmosData* tiles, const int32_t* nextTile, int32_t firstTile, int32_t gasCount, const AtmosConfig* config);
+    void (*queryTiles)(const TileAtmosData* tiles, const int32_t* indices, int32_t count, const AtmosConfig* config, const TileQueryOutputs* outputs);
+    int (*react)(TileAtmosData* tile, const AtmosConfig* config, uint32_t* reactedMask);
+    void (*processCell)(GridAtmosState* state, int32_t tileIndex, const AtmosConfig* config);
+    void (*processCellBatch)(GridAtmosState* state, const int32_t* tiles, int32_t count, LindaOpLog* log, const AtmosConfig* config);
+};
+
+ATMOS_INTERNAL const AtmosKernelTable* kernel_table_sse2();
+ATMOS_INTERNAL const AtmosKernelTable* kernel_table_sse41();
+ATMOS_INTERNAL const AtmosKernelTable* kernel_table_avx2();
+ATMOS_INTERNAL const AtmosKernelTable* kernel_table_avx512();
+ATMOS_INTERNAL uint32_t detect_cpu_simd_level();
+ATMOS_INTERNAL const AtmosKernelTable* select_kernel_table(uint32_t level);
+ATMOS_INTERNAL const AtmosKernelTable* atmos_kernel_table();
+
 ATMOS_INTERNAL float get_heat_capacity_impl(const float* moles, const float* specificHeats, bool space);
 ATMOS_INTERNAL float get_heat_capacity_archived_impl(const TileAtmosData* tile, const float* specificHeats);
 ATMOS_INTERNAL float get_thermal_energy_impl(const TileAtmosData* tile, const float* specificHeats);
 
 ATMOS_INTERNAL void archive_tile(TileAtmosData* tile);
+ATMOS_INTERNAL void begin_archive_epoch(GridAtmosState* state);
+ATMOS_INTERNAL void clear_unused_gases(const GridAtmosState* state, TileAtmosData* tile);
+ATMOS_INTERNAL void archive_tile_epoch(GridAtmosState* state, int32_t tileIndex);
+ATMOS_INTERNAL void archive_tile_and_neighbors(GridAtmosState* state, int32_t tileIndex);
 ATMOS_INTERNAL int compare_exchange(const TileAtmosData* a, const TileAtmosData* b, const AtmosConfig* config);
 
 ATMOS_INTERNAL void share_impl(TileAtmosData* receiver, TileAtmosData* sharer, int adjacentCount, const AtmosConfig* config);
@@ -30,20 +184,39 @@ ATMOS_INTERNAL float temperature_share_solid(TileAtmosData* receiver, float cond
 
 ATMOS_INTERNAL void process_cell(GridAtmosState* state, int32_t tileIndex, const AtmosConfig* config);
 ATMOS_INTERNAL void last_share_check(GridAtmosState* state, TileAtmosData* tile, const AtmosConfig* config);
+ATMOS_INTERNAL void apply_last_share(GridAtmosState* state, TileAtmosData* tile, float lastShare, float temperatureDelta, const AtmosConfig* config);
+ATMOS_INTERNAL void merge_cell_groups(GridAtmosState* state, int32_t tileIndex, int32_t adjIndex);
+ATMOS_INTERNAL void join_cell_groups(GridAtmosState* state, int32_t tileIndex, int32_t adjIndex);
+ATMOS_INTERNAL void finish_cell(GridAtmosState* state, int32_t tileIndex, float temperature, const AtmosConfig* config);
+ATMOS_INTERNAL int32_t process_active_tiles_batched(GridAtmosState* state, const AtmosConfig* config, AtmosBudget* budget, bool resume, bool* complete);
+ATMOS_INTERNAL void free_linda_scratch(GridAtmosState* state);
+
+
+ATMOS_INTERNAL bool tile_set_contains(const int32_t* items, int32_t count, const int32_t* slots, int32_t tileIndex);
+ATMOS_INTERNAL void tile_set_insert(int32_t** items, int32_t* count, int32_t* capacity, int32_t* slots, int32_t tileIndex);
+ATMOS_INTERNAL bool tile_set_remove(int32_t* items, int32_t* count, int32_t* slots, int32_t tileIndex);
 
 ATMOS_INTERNAL void add_active_tile_impl(GridAtmosState* state, int32_t tileIndex);
 ATMOS_INTERNAL void remove_active_tile_impl(GridAtmosState* state, int32_t tileIndex, bool disposeGroup);
 
 ATMOS_INTERNAL int32_t create_excited_group(GridAtmosState* state);
+ATMOS_INTERNAL int32_t resolve_excited_group(GridAtmosState* state, int32_t groupId);
 ATMOS_INTERNAL void add_tile_to_excited_group(GridAtmosState* state, int32_t groupId, int32_t tileIndex);
 ATMOS_INTERNAL void remove_tile_from_excited_group(GridAtmosState* state, int32_t groupId, int32_t tileIndex);
 ATMOS_INTERNAL void merge_excited_groups(GridAtmosState* state, int32_t group1, int32_t group2);
 ATMOS_INTERNAL void dispose_excited_group(GridAtmosState* state, int32_t groupId);
 ATMOS_INTERNAL void reset_excited_group_cooldowns(GridAtmosState* state, int32_t groupId);
+ATMOS_INTERNAL void sleep_excited_group(GridAtmosState* state, int32_t groupId);
+ATMOS_INTERNAL void wake_excited_group(GridAtmosState* state, int32_t groupId);
 ATMOS_INTERNAL void excited_group_self_breakdown(GridAtmosState* state, int32_t groupId, const AtmosConfig* config);
 ATMOS_INTERNAL void deactivate_group_tiles(GridAtmosState* state, int32_t groupId);
 
+ATMOS_INTERNAL MonstermosScratch* ensure_monstermos_scratch(GridAtmosState* state, const AtmosConfig* config);
+ATMOS_INTERNAL void free_monstermos_scratch(GridAtmosState* state);
+ATMOS_INTERNAL void sort_tiles_by_mole_delta(TileAtmosData** tiles, int32_t count, MonstermosScratch* scratch);
 ATMOS_INTERNAL void equalize_pressure_in_zone(GridAtmosState* state, int32_t startTile, const AtmosConfig* config);
+ATMOS_INTERNAL void equalize_pressure_coarse(GridAtmosState* state, int32_t startTile, TileAtmosData* const* zoneTiles, int32_t zoneCount,
+                                            const AtmosConfig* config);
 ATMOS_INTERNAL void explosive_depressurize(GridAtmosState* state, int32_t startTile, const AtmosConfig* config);
 ATMOS_INTERNAL void adjust_eq_movement(TileAtmosData* tile, TileAtmosData* adj, int direction, float amount);
 ATMOS_INTERNAL void finalize_eq(GridAtmosState* state, int32_t tileIndex, const AtmosConfig* config);
@@ -60,6 +233,13 @@ ATMOS_INTERNAL void radiate_to_space(TileAtmosData* tile, const AtmosConfig* con
 ATMOS_INTERNAL void finish_superconductivity(GridAtmosState* state, int32_t tileIndex, float temperature, const AtmosConfig* config);
 
 ATMOS_INTERNAL int react_impl(TileAtmosData* tile, const AtmosConfig* config);
+ATMOS_INTERNAL int react_tracked(TileAtmosData* tile, const AtmosConfig* config, uint32_t* reactedMask);
+ATMOS_INTERNAL int32_t register_reaction(const AtmosReactionDefinition* definition);
+ATMOS_INTERNAL void reset_reactions();
+ATMOS_INTERNAL int32_t reaction_count();
+ATMOS_INTERNAL void record_reactions(GridAtmosState* state, uint32_t reactedMask);
+ATMOS_INTERNAL const uint16_t* reaction_candidate_table();
+ATMOS_INTERNAL int react_candidates(TileAtmosData* tile, const AtmosConfig* config, uint32_t candidates, uint32_t* reactedMask);
 ATMOS_INTERNAL int plasma_fire_reaction(TileAtmosData* tile, const AtmosConfig* config);
 ATMOS_INTERNAL int tritium_fire_reaction(TileAtmosData* tile, const AtmosConfig* config);
 ATMOS_INTERNAL int frezon_coolant_reaction(TileAtmosData* tile, const AtmosConfig* config);
@@ -75,6 +255,32 @@ ATMOS_INTERNAL void remove_ratio_impl(TileAtmosData* tile, float ratio, TileAtmo
 ATMOS_INTERNAL void high_pressure_movements(GridAtmosState* state, int32_t tileIndex, const AtmosConfig* config);
 ATMOS_INTERNAL void consider_pressure_difference(GridAtmosState* state, int32_t tileIndex, int direction, float pressureDiff);
 
-ATMOS_INTERNAL void ensure_tile_capacity(GridAtmosState* state, int32_t needed);
+ATMOS_INTERNAL bool ensure_tile_capacity(GridAtmosState* state, int32_t needed);
+ATMOS_INTERNAL void build_tile_adjacency(GridAtmosState* state, int32_t begin, int32_t end);
+ATMOS_INTERNAL bool optimize_tile_layout(GridAtmosState* state, int32_t* outRemap);
+ATMOS_INTERNAL bool reserve_tile_storage(GridAtmosState* state, int32_t maxTiles);
+ATMOS_INTERNAL bool commit_tile_storage(GridAtmosState* state, int32_t capacity);
+ATMOS_INTERNAL void release_tile_storage(GridAtmosState* state);
 ATMOS_INTERNAL void ensure_active_capacity(GridAtmosState* state, int32_t needed);
-ATMOS_INTERNAL void ensure_excited_group_capacity(GridAtmosState* state, int32_t needed);
\ No newline at end of file
+ATMOS_INTERNAL void ensure_excited_group_capacity(GridAtmosState* state, int32_t needed);
+
+ATMOS_INTERNAL int64_t atmos_time_us();
+ATMOS_INTERNAL uint64_t stats_clock();
+ATMOS_INTERNAL int64_t stats_clock_to_ns(uint64_t ticks);
+ATMOS_INTERNAL void budget_start(AtmosBudget* budget, int64_t microseconds);
+ATMOS_INTERNAL bool budget_expired(AtmosBudget* budget);
+ATMOS_INTERNAL bool budget_expired_now(AtmosBudget* budget);
+
+ATMOS_INTERNAL bool run_archive_phase(GridAtmosState* state, int32_t* cursor, AtmosBudget* budget);
+ATMOS_INTERNAL bool run_active_phase(GridAtmosState* state, const AtmosConfig* config, int32_t* cursor, AtmosBudget* budget, AtmosResult* result);
+ATMOS_INTERNAL bool run_excited_groups_phase(GridAtmosState* state, const AtmosConfig* config, int32_t* cursor, AtmosBudget* budget);
+ATMOS_INTERNAL bool run_hotspot_phase(GridAtmosState* state, const AtmosConfig* config, int32_t* cursor, AtmosBudget* budget);
+ATMOS_INTERNAL bool run_superconduct_phase(GridAtmosState* state, const AtmosConfig* config, int32_t* cursor, AtmosBudget* budget);
+ATMOS_INTERNAL bool run_high_pressure_phase(GridAtmosState* state, const AtmosConfig* config, int32_t* cursor, AtmosBudget* budget, AtmosResult* result);
+ATMOS_INTERNAL AtmosResult process_tick(GridAtmosState* state, const AtmosConfig* config);
+
+ATMOS_INTERNAL bool thread_pool_set_size(int32_t threads);
+ATMOS_INTERNAL int32_t thread_pool_get_size();
+ATMOS_INTERNAL bool thread_pool_busy();
+ATMOS_INTERNAL void thread_pool_stop();
+ATMOS_INTERNAL void thread_pool_parallel_for(int32_t count, int32_t grain, AtmosJobFn fn, void* context);
\ No newline at end of file
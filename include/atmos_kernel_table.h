@@ -0,0 +1,409 @@
+#pragma once
+
+#include "atmos_kernels.h"
+#include <stdlib.h>
+
+namespace
+{
+
+float table_heat_capacity(const float* moles, const float* specificHeats, bool space)
+{
+    return heat_capacity_kernel(moles, specificHeats, space);
+}
+
+float table_heat_capacity_archived(const TileAtmosData* tile, const float* specificHeats)
+{
+    return heat_capacity_kernel(tile->molesArchived, specificHeats, (tile->flags & TILE_FLAG_SPACE) != 0);
+}
+
+void table_share(TileAtmosData* receiver, TileAtmosData* sharer, int adjacentCount, const AtmosConfig* config)
+{
+    share_t<ATMOS_GAS_ARRAY_SIZE>(receiver, sharer, adjacentCount, config);
+}
+
+float table_temperature_share(TileAtmosData* receiver, TileAtmosData* sharer, float conductionCoefficient, const AtmosConfig* config)
+{
+    return temperature_share_t(receiver, sharer, conductionCoefficient, config);
+}
+
+template <int GasCount>
+void table_group_breakdown_t(TileAtmosData* tiles, const int32_t* nextTile, int32_t firstTile, const AtmosConfig* config)
+{
+    float combinedMoles[ATMOS_GAS_ARRAY_SIZE] = {0};
+    float combinedHeatCapacity = 0.0f;
+    float combinedTemperature = 0.0f;
+    int32_t mutableTiles = 0;
+
+    for (int32_t tileIdx = firstTile; tileIdx >= 0; tileIdx = nextTile[tileIdx])
+    {
+        const TileAtmosData* tile = &tiles[tileIdx];
+        if (tile->flags & TILE_FLAG_IMMUTABLE)
+            continue;
+
+        float heatCapacity = heat_capacity_kernel(tile->moles, config->gasSpecificHeats, (tile->flags & TILE_FLAG_SPACE) != 0);
+        combinedHeatCapacity += heatCapacity;
+        combinedTemperature += tile->temperature * heatCapacity;
+        simd_add_arrays(combinedMoles, tile->moles, GasCount);
+        mutableTiles++;
+    }
+
+    if (mutableTiles == 0)
+        return;
+
+    if (combinedHeatCapacity > config->constants.minimumHeatCapacity)
+        combinedTemperature /= combinedHeatCapacity;
+
+    simd_mul_scalar(combinedMoles, 1.0f / mutableTiles, GasCount);
+
+    for (int32_t tileIdx = firstTile; tileIdx >= 0; tileIdx = nextTile[tileIdx])
+    {
+        TileAtmosData* tile = &tiles[tileIdx];
+        if (tile->flags & TILE_FLAG_IMMUTABLE)
+            continue;
+
+        tile->temperature = combinedTemperature;
+        simd_copy(tile->moles, combinedMoles, GasCount);
+    }
+}
+
+void table_group_breakdown(TileAtmosData* tiles, const int32_t* nextTile, int32_t firstTile, int32_t gasCount, const AtmosConfig* config)
+{
+    switch (gasCount)
+    {
+        case 8: table_group_breakdown_t<8>(tiles, nextTile, firstTile, config); break;
+        case 12: table_group_breakdown_t<12>(tiles, nextTile, firstTile, config); break;
+        default: table_group_breakdown_t<ATMOS_GAS_COUNT>(tiles, nextTile, firstTile, config); break;
+    }
+}
+
+void table_query_tiles(const TileAtmosData* tiles, const int32_t* indices, int32_t count, const AtmosConfig* config, const TileQueryOutputs* outputs)
+{
+    float R = config->constants.R;
+    float volume = config->constants.cellVolume;
+
+    for (int32_t i = 0; i < count; i++)
+    {
+        const TileAtmosData* tile = &tiles[indices ? indices[i] : i];
+
+        float totalMoles = simd_horizontal_add(tile->moles, ATMOS_GAS_ARRAY_SIZE);
+        float heatCapacity = (tile->flags & TILE_FLAG_SPACE) && totalMoles < 0.0001f
+            ? 7000.0f
+            : simd_max(simd_dot_product(tile->moles, config->gasSpecificHeats, ATMOS_GAS_ARRAY_SIZE), 0.0003f);
+
+        if (outputs->heatCapacity)
+            outputs->heatCapacity[i] = heatCapacity;
+        if (outputs->pressure)
+            outputs->pressure[i] = volume > 0.0f ? totalMoles * R * tile->temperature / volume : 0.0f;
+        if (outputs->totalMoles)
+            outputs->totalMoles[i] = totalMoles;
+        if (outputs->thermalEnergy)
+            outputs->thermalEnergy[i] = heatCapacity * tile->temperature;
+    }
+}
+
+int table_react(TileAtmosData* tile, const AtmosConfig* config, uint32_t* reactedMask)
+{
+    if (reactedMask)
+        *reactedMask = 0;
+
+    if (tile->flags & TILE_FLAG_IMMUTABLE)
+        return REACTION_NONE;
+
+    uint32_t candidates = reaction_candidate_table()[present_gas_mask(tile->moles)];
+    if (!candidates)
+        return REACTION_NONE;
+
+    float heatCapacity = heat_capacity_kernel(tile->moles, config->gasSpecificHeats, (tile->flags & TILE_FLAG_SPACE) != 0);
+    if (tile->temperature * heatCapacity < REACTION_MIN_ENERGY)
+        return REACTION_NONE;
+
+    return react_candidates(tile, config, candidates, reactedMask);
+}
+
+struct LindaDirectSink
+{
+    GridAtmosState* state;
+    const AtmosConfig* config;
+
+    bool in_group(int32_t tileIndex)
+    {
+        return state->tiles[tileIndex].excitedGroupId >= 0;
+    }
+
+    void merge(int32_t tileIndex, int32_t adjIndex)
+    {
+        merge_cell_groups(state, tileIndex, adjIndex);
+    }
+
+    void activate(int32_t adjIndex)
+    {
+        add_active_tile_impl(state, adjIndex);
+    }
+
+    void join(int32_t tileIndex, int32_t adjIndex)
+    {
+        join_cell_groups(state, tileIndex, adjIndex);
+    }
+
+    void pressure(int32_t tileIndex, int direction, float difference)
+    {
+        consider_pressure_difference(state, tileIndex, direction, difference);
+    }
+
+    void last_share(int32_t tileIndex, float lastShare, float temperatureDelta)
+    {
+        apply_last_share(state, &state->tiles[tileIndex], lastShare, temperatureDelta, config);
+    }
+
+    void reactions(int32_t tileIndex, uint32_t reactedMask)
+    {
+        (void)tileIndex;
+        record_reactions(state, reactedMask);
+    }
+
+    void finish(int32_t tileIndex, float temperature)
+    {
+        finish_cell(state, tileIndex, temperature, config);
+    }
+};
+
+// Drops ops that would be no-ops on replay. Cells of one colour touch disjoint tiles, so
+// only the cell itself changes the state these checks read before its log is replayed.
+// Activation is always logged: replaying an earlier cell can put a group to sleep.
+struct LindaDeferredSink
+{
+    GridAtmosState* state;
+    const AtmosConfig* config;
+    LindaOpLog* log;
+    int32_t joined[ATMOS_DIRECTIONS + 1];
+    int32_t joinedCount;
+
+    void record(uint8_t type, int32_t tileIndex, int32_t otherIndex, int direction, float value, float auxValue = 0.0f)
+    {
+        LindaCellOp* op = &log->ops[log->count++];
+        op->type = type;
+        op->direction = (uint8_t)direction;
+        op->tileIndex = tileIndex;
+        op->otherIndex = otherIndex;
+        op->value = value;
+        op->auxValue = auxValue;
+    }
+
+    void mark_joined(int32_t tileIndex)
+    {
+        for (int i = 0; i < joinedCount; i++)
+        {
+            if (joined[i] == tileIndex)
+                return;
+        }
+        joined[joinedCount++] = tileIndex;
+    }
+
+    bool in_group(int32_t tileIndex)
+    {
+        if (state->tiles[tileIndex].excitedGroupId >= 0)
+            return true;
+
+        for (int i = 0; i < joinedCount; i++)
+        {
+            if (joined[i] == tileIndex)
+                return true;
+        }
+        return false;
+    }
+
+    void merge(int32_t tileIndex, int32_t adjIndex)
+    {
+        int32_t groupId = state->tiles[tileIndex].excitedGroupId;
+        if (groupId >= 0 && groupId == state->tiles[adjIndex].excitedGroupId)
+            return;
+
+        record(LINDA_OP_MERGE, tileIndex, adjIndex, 0, 0.0f);
+    }
+
+    void activate(int32_t adjIndex)
+    {
+        record(LINDA_OP_ACTIVATE, adjIndex, -1, 0, 0.0f);
+    }
+
+    void join(int32_t tileIndex, int32_t adjIndex)
+    {
+        record(LINDA_OP_JOIN, tileIndex, adjIndex, 0, 0.0f);
+        mark_joined(tileIndex);
+        mark_joined(adjIndex);
+    }
+
+    void pressure(int32_t tileIndex, int direction, float difference)
+    {
+        record(LINDA_OP_PRESSURE, tileIndex, -1, direction, difference);
+    }
+
+    void last_share(int32_t tileIndex, float lastShare, float temperatureDelta)
+    {
+        if (!in_group(tileIndex))
+            return;
+
+        record(LINDA_OP_LAST_SHARE, tileIndex, -1, 0, lastShare, temperatureDelta);
+    }
+
+    void reactions(int32_t tileIndex, uint32_t reactedMask)
+    {
+        record(LINDA_OP_REACTIONS, tileIndex, (int32_t)reactedMask, 0, 0.0f);
+    }
+
+    void finish(int32_t tileIndex, float temperature)
+    {
+        bool superconduct = config->superconductionEnabled &&
+                            temperature > config->constants.minimumTemperatureStartSuperConduction;
+        if (!superconduct && (!config->excitedGroupsEnabled || in_group(tileIndex)))
+            return;
+
+        record(LINDA_OP_FINISH, tileIndex, -1, 0, temperature);
+    }
+};
+
+template <int GasCount, typename Sink>
+void process_cell_t(GridAtmosState* state, int32_t tileIndex, const AtmosConfig* config, Sink& sink)
+{
+    TileAtmosData* tile = &state->tiles[tileIndex];
+
+    tile->lastCycle = state->updateCounter;
+
+    uint8_t adjacentBits = tile->adjacentBits;
+
+    int adjacentTileLength = 0;
+    for (int i = 0; i < ATMOS_DIRECTIONS; i++)
+    {
+        if (adjacentBits & (1 << i))
+            adjacentTileLength++;
+    }
+
+    for (int i = 0; i < ATMOS_DIRECTIONS; i++)
+    {
+        uint8_t dirBit = (1 << i);
+        if (!(adjacentBits & dirBit))
+            continue;
+
+        int32_t adjIndex = tile->adjacentIndices[i];
+        if (adjIndex < 0 || adjIndex >= state->tileCount)
+            continue;
+
+        TileAtmosData* enemyTile = &state->tiles[adjIndex];
+        if (enemyTile->flags & TILE_FLAG_IMMUTABLE)
+            continue;
+
+        if (state->updateCounter <= enemyTile->lastCycle)
+            continue;
+
+        bool shouldShareAir = false;
+
+        if (config->excitedGroupsEnabled &&
+            sink.in_group(tileIndex) &&
+            sink.in_group(adjIndex))
+        {
+            sink.merge(tileIndex, adjIndex);
+            shouldShareAir = true;
+        }
+        else
+        {
+            int exchangeResult = compare_exchange_t<GasCount>(tile, enemyTile, config);
+            if (exchangeResult != -2)
+            {
+                sink.activate(adjIndex);
+
+                if (config->excitedGroupsEnabled)
+                    sink.join(tileIndex, adjIndex);
+
+                shouldShareAir = true;
+            }
+        }
+
+        if (shouldShareAir)
+        {
+            share_t<GasCount>(tile, enemyTile, adjacentTileLength, config);
+
+            if (!config->monstermosEnabled)
+            {
+                float pressure1 = tile_pressure_t<GasCount>(tile, config->constants.R, config->constants.cellVolume);
+                float pressure2 = tile_pressure_t<GasCount>(enemyTile, config->constants.R, config->constants.cellVolume);
+                float difference = pressure1 - pressure2;
+
+                if (difference >= 0)
+                {
+                    sink.pressure(tileIndex, i, difference);
+                }
+                else
+                {
+                    sink.pressure(adjIndex, opposite_dir(i), -difference);
+                }
+            }
+
+            sink.last_share(tileIndex, tile->lastShare, simd_abs(tile->temperature - enemyTile->temperature));
+        }
+    }
+
+    uint32_t reactedMask;
+    table_react(tile, config, &reactedMask);
+    if (reactedMask)
+        sink.reactions(tileIndex, reactedMask);
+
+    sink.finish(tileIndex, tile->temperature);
+}
+
+template <typename Sink>
+void process_cell_dispatch(GridAtmosState* state, int32_t tileIndex, const AtmosConfig* config, Sink& sink)
+{
+    switch (state->gasCount)
+    {
+        case 8: process_cell_t<8>(state, tileIndex, config, sink); break;
+        case 12: process_cell_t<12>(state, tileIndex, config, sink); break;
+        default: process_cell_t<ATMOS_GAS_COUNT>(state, tileIndex, config, sink); break;
+    }
+}
+
+void table_process_cell(GridAtmosState* state, int32_t tileIndex, const AtmosConfig* config)
+{
+    LindaDirectSink sink = { state, config };
+    process_cell_dispatch(state, tileIndex, config, sink);
+}
+
+void table_process_cell_batch(GridAtmosState* state, const int32_t* tiles, int32_t count, LindaOpLog* log, const AtmosConfig* config)
+{
+    LindaDeferredSink sink;
+    sink.state = state;
+    sink.config = config;
+    sink.log = log;
+
+    for (int32_t i = 0; i < count; i++)
+    {
+        if (log->count + LINDA_MAX_CELL_OPS > log->capacity)
+        {
+            log->capacity = log->capacity > 0 ? log->capacity * 2 : 4 * LINDA_BATCH_GRAIN;
+            log->ops = (LindaCellOp*)realloc(log->ops, log->capacity * sizeof(LindaCellOp));
+        }
+
+        sink.joinedCount = 0;
+        process_cell_dispatch(state, tiles[i], config, sink);
+    }
+}
+
+}
+
+#define ATMOS_DEFINE_KERNEL_TABLE(name)                 \
+    const AtmosKernelTable* name()                      \
+    {                                                   \
+        static const AtmosKernelTable table =           \
+        {                                               \
+            ATMOS_SIMD_COMPILED_LEVEL,                  \
+            table_heat_capacity,                        \
+            table_heat_capacity_archived,               \
+            table_share,                                \
+            table_temperature_share,                    \
+            table_group_breakdown,                      \
+            table_query_tiles,                          \
+            table_react,                                \
+            table_process_cell,                         \
+            table_process_cell_batch,                   \
+        };                                              \
+        return &table;                                  \
+    }
@@ -0,0 +1,185 @@
+#pragma once
+
+#include "atmos_internal.h"
+
+#define REACTION_NONE          0
+#define REACTION_REACTING      1
+#define REACTION_STOP          2
+#define REACTION_MIN_GAS_MOLES 0.5f
+#define REACTION_MIN_ENERGY    1000.0f
+
+// Internal linkage keeps each translation unit's copy compiled for its own ISA flags.
+namespace
+{
+
+ATMOS_INLINE float heat_capacity_kernel(const float* moles, const float* specificHeats, bool space)
+{
+    if (space && simd_horizontal_add(moles, ATMOS_GAS_ARRAY_SIZE) < 0.0001f)
+        return 7000.0f;
+
+    float heatCapacity = simd_dot_product(moles, specificHeats, ATMOS_GAS_ARRAY_SIZE);
+    return simd_max(heatCapacity, 0.0003f);
+}
+
+ATMOS_INLINE uint32_t present_gas_mask(const float* moles)
+{
+    __m128 threshold = _mm_set1_ps(REACTION_MIN_GAS_MOLES);
+    uint32_t mask = (uint32_t)_mm_movemask_ps(_mm_cmpge_ps(_mm_loadu_ps(moles), threshold));
+    mask |= (uint32_t)_mm_movemask_ps(_mm_cmpge_ps(_mm_loadu_ps(moles + 4), threshold)) << 4;
+    mask |= (uint32_t)_mm_movemask_ps(_mm_cmpge_ps(_mm_loadu_ps(moles + 8), threshold)) << 8;
+    return mask & ((1u << ATMOS_GAS_ARRAY_SIZE) - 1);
+}
+
+template <int GasCount>
+ATMOS_INLINE float tile_pressure_t(const TileAtmosData* tile, float R, float volume)
+{
+    if (volume <= 0.0f) return 0.0f;
+
+    float total = 0.0f;
+    for (int i = 0; i < GasCount; i++)
+        total += tile->moles[i];
+    return total * R * tile->temperature / volume;
+}
+
+template <int GasCount>
+inline int compare_exchange_t(const TileAtmosData* a, const TileAtmosData* b, const AtmosConfig* config)
+{
+    float totalMoles = 0.0f;
+
+    for (int i = 0; i < GasCount; i++)
+    {
+        float gasMoles = a->moles[i];
+        float delta = simd_abs(gasMoles - b->moles[i]);
+
+        if (delta > config->constants.minimumMolesDeltaToMove &&
+            delta > gasMoles * config->constants.minimumAirRatioToMove)
+        {
+            return i;
+        }
+        totalMoles += gasMoles;
+    }
+
+    if (totalMoles > config->constants.minimumMolesDeltaToMove)
+    {
+        float tempDelta = simd_abs(a->temperature - b->temperature);
+        if (tempDelta > config->constants.minimumTemperatureDeltaToSuspend)
+            return -1;
+    }
+
+    return -2;
+}
+
+inline float temperature_share_t(TileAtmosData* receiver, TileAtmosData* sharer, float conductionCoefficient, const AtmosConfig* config)
+{
+    float temperatureDelta = receiver->temperatureArchived - sharer->temperatureArchived;
+
+    if (simd_abs(temperatureDelta) > config->constants.minimumTemperatureDeltaToConsider)
+    {
+        float heatCapacity = heat_capacity_kernel(receiver->molesArchived, config->gasSpecificHeats, (receiver->flags & TILE_FLAG_SPACE) != 0);
+        float sharerHeatCapacity = heat_capacity_kernel(sharer->molesArchived, config->gasSpecificHeats, (sharer->flags & TILE_FLAG_SPACE) != 0);
+
+        if (sharerHeatCapacity > config->constants.minimumHeatCapacity &&
+            heatCapacity > config->constants.minimumHeatCapacity)
+        {
+            float heat = conductionCoefficient * temperatureDelta *
+                        (heatCapacity * sharerHeatCapacity / (heatCapacity + sharerHeatCapacity));
+
+            if (!(receiver->flags & TILE_FLAG_IMMUTABLE))
+            {
+                receiver->temperature = simd_max(receiver->temperature - heat / heatCapacity, config->constants.TCMB);
+            }
+
+            if (!(sharer->flags & TILE_FLAG_IMMUTABLE))
+            {
+                sharer->temperature = simd_max(sharer->temperature + heat / sharerHeatCapacity, config->constants.TCMB);
+            }
+        }
+    }
+
+    return sharer->temperature;
+}
+
+template <int GasCount>
+inline void share_t(TileAtmosData* receiver, TileAtmosData* sharer, int adjacentCount, const AtmosConfig* config)
+{
+    bool receiverImmutable = (receiver->flags & TILE_FLAG_IMMUTABLE) != 0;
+    bool sharerImmutable = (sharer->flags & TILE_FLAG_IMMUTABLE) != 0;
+
+    float temperatureDelta = receiver->temperatureArchived - sharer->temperatureArchived;
+    float absTemperatureDelta = simd_abs(temperatureDelta);
+
+    float oldHeatCapacity = 0.0f;
+    float oldSharerHeatCapacity = 0.0f;
+
+    if (absTemperatureDelta > config->constants.minimumTemperatureDeltaToConsider)
+    {
+        oldHeatCapacity = heat_capacity_kernel(receiver->moles, config->gasSpecificHeats, (receiver->flags & TILE_FLAG_SPACE) != 0);
+        oldSharerHeatCapacity = heat_capacity_kernel(sharer->moles, config->gasSpecificHeats, (sharer->flags & TILE_FLAG_SPACE) != 0);
+    }
+
+    float heatCapacityToSharer = 0.0f;
+    float heatCapacitySharerToThis = 0.0f;
+    float movedMoles = 0.0f;
+    float absMovedMoles = 0.0f;
+
+    float divisor = 1.0f / (adjacentCount + 1);
+
+    for (int i = 0; i < GasCount; i++)
+    {
+        float thisValue = receiver->moles[i];
+        float sharerValue = sharer->moles[i];
+        float delta = (thisValue - sharerValue) * divisor;
+
+        if (simd_abs(delta) < config->constants.gasMinMoles)
+            continue;
+
+        if (absTemperatureDelta > config->constants.minimumTemperatureDeltaToConsider)
+        {
+            float gasHeatCapacity = delta * config->gasSpecificHeats[i];
+            if (delta > 0)
+                heatCapacityToSharer += gasHeatCapacity;
+            else
+                heatCapacitySharerToThis -= gasHeatCapacity;
+        }
+
+        if (!receiverImmutable)
+            receiver->moles[i] -= delta;
+        if (!sharerImmutable)
+            sharer->moles[i] += delta;
+
+        movedMoles += delta;
+        absMovedMoles += simd_abs(delta);
+    }
+
+    receiver->lastShare = absMovedMoles;
+
+    if (absTemperatureDelta > config->constants.minimumTemperatureDeltaToConsider)
+    {
+        float newHeatCapacity = oldHeatCapacity + heatCapacitySharerToThis - heatCapacityToSharer;
+        float newSharerHeatCapacity = oldSharerHeatCapacity + heatCapacityToSharer - heatCapacitySharerToThis;
+
+        if (!receiverImmutable && newHeatCapacity > config->constants.minimumHeatCapacity)
+        {
+            receiver->temperature = ((oldHeatCapacity * receiver->temperature) -
+                                      (heatCapacityToSharer * receiver->temperatureArchived) +
+                                      (heatCapacitySharerToThis * sharer->temperatureArchived)) / newHeatCapacity;
+        }
+
+        if (!sharerImmutable && newSharerHeatCapacity > config->constants.minimumHeatCapacity)
+        {
+            sharer->temperature = ((oldSharerHeatCapacity * sharer->temperature) -
+                                    (heatCapacitySharerToThis * sharer->temperatureArchived) +
+                                    (heatCapacityToSharer * receiver->temperatureArchived)) / newSharerHeatCapacity;
+        }
+
+        if (simd_abs(oldSharerHeatCapacity) > config->constants.minimumHeatCapacity)
+        {
+            if (simd_abs(newSharerHeatCapacity / oldSharerHeatCapacity - 1.0f) < 0.1f)
+            {
+                temperature_share_t(receiver, sharer, config->constants.openHeatTransferCoefficient, config);
+            }
+        }
+    }
+}
+
+}
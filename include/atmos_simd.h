@@ -9,7 +9,23 @@
 #define ATMOS_INLINE __attribute__((always_inline)) inline
 #endif
 
-ATMOS_INLINE float hsum256_ps(__m256 v)
+#define ATMOS_SIMD_SSE2   0
+#define ATMOS_SIMD_SSE41  1
+#define ATMOS_SIMD_AVX2   2
+#define ATMOS_SIMD_AVX512 3
+
+#if defined(__AVX512F__)
+#define ATMOS_SIMD_COMPILED_LEVEL ATMOS_SIMD_AVX512
+#elif defined(__AVX2__)
+#define ATMOS_SIMD_COMPILED_LEVEL ATMOS_SIMD_AVX2
+#elif defined(__SSE4_1__)
+#define ATMOS_SIMD_COMPILED_LEVEL ATMOS_SIMD_SSE41
+#else
+#define ATMOS_SIMD_COMPILED_LEVEL ATMOS_SIMD_SSE2
+#endif
+
+#if defined(__AVX__)
+static ATMOS_INLINE float hsum256_ps(__m256 v)
 {
     __m128 vlow = _mm256_castps256_ps128(v);
     __m128 vhigh = _mm256_extractf128_ps(v, 1);
@@ -21,25 +37,61 @@ ATMOS_INLINE float hsum256_ps(__m256 v)
     return _mm_cvtss_f32(sums);
 }
 
-ATMOS_INLINE float hsum128_ps(__m128 v)
+#endif
+
+#if defined(__AVX512F__)
+static ATMOS_INLINE float hsum512_ps(__m512 v)
+{
+    // Zero-masked extracts: GCC 12's unmasked forms (and the 512->256 cast) merge into an
+    // undefined register and trip -Wmaybe-uninitialized.
+    __m512d pd = _mm512_castps_pd(v);
+    __m256 vlow = _mm256_castpd_ps(_mm512_maskz_extractf64x4_pd(0xFF, pd, 0));
+    __m256 vhigh = _mm256_castpd_ps(_mm512_maskz_extractf64x4_pd(0xFF, pd, 1));
+    return hsum256_ps(_mm256_add_ps(vlow, vhigh));
+}
+
+#endif
+
+static ATMOS_INLINE float hsum128_ps(__m128 v)
 {
+#if defined(__SSE3__)
     __m128 shuf = _mm_movehdup_ps(v);
+#else
+    __m128 shuf = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 1, 1));
+#endif
     __m128 sums = _mm_add_ps(v, shuf);
     shuf = _mm_movehl_ps(shuf, sums);
     sums = _mm_add_ss(sums, shuf);
     return _mm_cvtss_f32(sums);
 }
 
-ATMOS_INLINE float simd_horizontal_add(const float* arr, int count)
+static ATMOS_INLINE float simd_horizontal_add(const float* arr, int count)
 {
+#if defined(__AVX512F__)
+    __m512 acc = _mm512_setzero_ps();
+    int i = 0;
+
+    for (; i + 16 <= count; i += 16)
+        acc = _mm512_add_ps(acc, _mm512_loadu_ps(arr + i));
+
+    if (i < count)
+    {
+        __mmask16 mask = (__mmask16)((1u << (count - i)) - 1);
+        acc = _mm512_add_ps(acc, _mm512_maskz_loadu_ps(mask, arr + i));
+    }
+
+    return hsum512_ps(acc);
+#else
     float sum = 0.0f;
     int i = 0;
 
+#if defined(__AVX__)
     for (; i + 8 <= count; i += 8)
     {
         __m256 v = _mm256_loadu_ps(arr + i);
         sum += hsum256_ps(v);
     }
+#endif
 
     for (; i + 4 <= count; i += 4)
     {
@@ -51,13 +103,30 @@ ATMOS_INLINE float simd_horizontal_add(const float* arr, int count)
         sum += arr[i];
 
     return sum;
+#endif
 }
 
-ATMOS_INLINE float simd_dot_product(const float* a, const float* b, int count)
+static ATMOS_INLINE float simd_dot_product(const float* a, const float* b, int count)
 {
+#if defined(__AVX512F__)
+    __m512 acc = _mm512_setzero_ps();
+    int i = 0;
+
+    for (; i + 16 <= count; i += 16)
+        acc = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), acc);
+
+    if (i < count)
+    {
+        __mmask16 mask = (__mmask16)((1u << (count - i)) - 1);
+        acc = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, a + i), _mm512_maskz_loadu_ps(mask, b + i), acc);
+    }
+
+    return hsum512_ps(acc);
+#else
     float sum = 0.0f;
     int i = 0;
 
+#if defined(__AVX__)
     for (; i + 8 <= count; i += 8)
     {
         __m256 va = _mm256_loadu_ps(a + i);
@@ -65,31 +134,39 @@ ATMOS_INLINE float simd_dot_product(const float* a, const float* b, int count)
         __m256 prod = _mm256_mul_ps(va, vb);
         sum += hsum256_ps(prod);
     }
+#endif
 
     for (; i + 4 <= count; i += 4)
     {
         __m128 va = _mm_loadu_ps(a + i);
         __m128 vb = _mm_loadu_ps(b + i);
+#if defined(__SSE4_1__)
+        sum += _mm_cvtss_f32(_mm_dp_ps(va, vb, 0xF1));
+#else
         __m128 prod = _mm_mul_ps(va, vb);
         sum += hsum128_ps(prod);
+#endif
     }
 
     for (; i < count; i++)
         sum += a[i] * b[i];
 
     return sum;
+#endif
 }
 
-ATMOS_INLINE void simd_add_arrays(float* dst, const float* src, int count)
+static ATMOS_INLINE void simd_add_arrays(float* dst, const float* src, int count)
 {
     int i = 0;
 
+#if defined(__AVX__)
     for (; i + 8 <= count; i += 8)
     {
         __m256 vd = _mm256_loadu_ps(dst + i);
         __m256 vs = _mm256_loadu_ps(src + i);
         _mm256_storeu_ps(dst + i, _mm256_add_ps(vd, vs));
     }
+#endif
 
     for (; i + 4 <= count; i += 4)
     {
@@ -102,16 +179,18 @@ ATMOS_INLINE void simd_add_arrays(float* dst, const float* src, int count)
         dst[i] += src[i];
 }
 
-ATMOS_INLINE void simd_sub_arrays(float* dst, const float* src, int count)
+static ATMOS_INLINE void simd_sub_arrays(float* dst, const float* src, int count)
 {
     int i = 0;
 
+#if defined(__AVX__)
     for (; i + 8 <= count; i += 8)
     {
         __m256 vd = _mm256_loadu_ps(dst + i);
         __m256 vs = _mm256_loadu_ps(src + i);
         _mm256_storeu_ps(dst + i, _mm256_sub_ps(vd, vs));
     }
+#endif
 
     for (; i + 4 <= count; i += 4)
     {
@@ -124,17 +203,21 @@ ATMOS_INLINE void simd_sub_arrays(float* dst, const float* src, int count)
         dst[i] -= src[i];
 }
 
-ATMOS_INLINE void simd_mul_scalar(float* arr, float scalar, int count)
+static ATMOS_INLINE void simd_mul_scalar(float* arr, float scalar, int count)
 {
     int i = 0;
+#if defined(__AVX__)
     __m256 vs256 = _mm256_set1_ps(scalar);
+#endif
     __m128 vs128 = _mm_set1_ps(scalar);
 
+#if defined(__AVX__)
     for (; i + 8 <= count; i += 8)
     {
         __m256 v = _mm256_loadu_ps(arr + i);
         _mm256_storeu_ps(arr + i, _mm256_mul_ps(v, vs256));
     }
+#endif
 
     for (; i + 4 <= count; i += 4)
     {
@@ -146,15 +229,17 @@ ATMOS_INLINE void simd_mul_scalar(float* arr, float scalar, int count)
         arr[i] *= scalar;
 }
 
-ATMOS_INLINE void simd_copy(float* dst, const float* src, int count)
+static ATMOS_INLINE void simd_copy(float* dst, const float* src, int count)
 {
     int i = 0;
 
+#if defined(__AVX__)
     for (; i + 8 <= count; i += 8)
     {
         __m256 v = _mm256_loadu_ps(src + i);
         _mm256_storeu_ps(dst + i, v);
     }
+#endif
 
     for (; i + 4 <= count; i += 4)
     {
@@ -166,14 +251,18 @@ ATMOS_INLINE void simd_copy(float* dst, const float* src, int count)
         dst[i] = src[i];
 }
 
-ATMOS_INLINE void simd_zero(float* arr, int count)
+static ATMOS_INLINE void simd_zero(float* arr, int count)
 {
     int i = 0;
+#if defined(__AVX__)
     __m256 zero256 = _mm256_setzero_ps();
+#endif
     __m128 zero128 = _mm_setzero_ps();
 
+#if defined(__AVX__)
     for (; i + 8 <= count; i += 8)
         _mm256_storeu_ps(arr + i, zero256);
+#endif
 
     for (; i + 4 <= count; i += 4)
         _mm_storeu_ps(arr + i, zero128);
@@ -182,24 +271,24 @@ ATMOS_INLINE void simd_zero(float* arr, int count)
         arr[i] = 0.0f;
 }
 
-ATMOS_INLINE float simd_clamp(float val, float min_val, float max_val)
+static ATMOS_INLINE float simd_clamp(float val, float min_val, float max_val)
 {
     if (val < min_val) return min_val;
     if (val > max_val) return max_val;
     return val;
 }
 
-ATMOS_INLINE float simd_max(float a, float b)
+static ATMOS_INLINE float simd_max(float a, float b)
 {
     return a > b ? a : b;
 }
 
-ATMOS_INLINE float simd_min(float a, float b)
+static ATMOS_INLINE float simd_min(float a, float b)
 {
     return a < b ? a : b;
 }
 
-ATMOS_INLINE float simd_abs(float v)
+static ATMOS_INLINE float simd_abs(float v)
 {
     return v < 0 ? -v : v;
 }
\ No newline at end of file
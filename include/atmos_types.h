@@ -26,6 +26,28 @@
 #define TILE_FLAG_SUPERCONDUCT (1 << 5)
 #define TILE_FLAG_PROCESSED   (1 << 6)
 
+#define ATMOS_PHASE_ARCHIVE        0
+#define ATMOS_PHASE_ACTIVE         1
+#define ATMOS_PHASE_EXCITED_GROUPS 2
+#define ATMOS_PHASE_HOTSPOTS       3
+#define ATMOS_PHASE_SUPERCONDUCT   4
+#define ATMOS_PHASE_HIGH_PRESSURE  5
+#define ATMOS_PHASE_COUNT          6
+
+#define ATMOS_REACTION_PLASMA_FIRE       0
+#define ATMOS_REACTION_TRITIUM_FIRE      1
+#define ATMOS_REACTION_FREZON_PRODUCTION 2
+#define ATMOS_REACTION_FREZON_COOLANT    3
+#define ATMOS_REACTION_WATER_VAPOR       4
+#define ATMOS_REACTION_N2O_DECOMPOSITION 5
+#define ATMOS_REACTION_AMMONIA_OXYGEN    6
+#define ATMOS_REACTION_TYPE_COUNT        7
+#define ATMOS_REACTION_MAX_COUNT         16
+
+#define ATMOS_REACTION_RATE_CONSTANT            0
+#define ATMOS_REACTION_RATE_LIMITING            1
+#define ATMOS_REACTION_RATE_TEMPERATURE_SCALED  2
+
 #define GAS_OXYGEN        0
 #define GAS_NITROGEN      1
 #define GAS_CO2           2
@@ -79,10 +101,17 @@ struct ExcitedGroupData
     int32_t breakdownCooldown;
     int32_t dismantleCooldown;
     int32_t tileCount;
-    int32_t tileCapacity;
-    int32_t* tileIndices;
+    int32_t parent;
+    int32_t firstTile;
+    int32_t lastTile;
+    int32_t nextMember;
+    int32_t lastMember;
+    float peakShare;
+    float peakTemperatureDelta;
+    int32_t calmCycles;
     uint8_t disposed;
-    uint8_t padding[3];
+    uint8_t sleeping;
+    uint8_t padding[2];
 };
 
 struct AtmosConstants
@@ -133,8 +162,11 @@ struct AtmosConstants
 
     int32_t excitedGroupBreakdownCycles;
     int32_t excitedGroupsDismantleCycles;
+    int32_t excitedGroupSleepCycles;
     int32_t monstermosHardTileLimit;
     int32_t monstermosTileLimit;
+    int32_t monstermosCoarseTileLimit;
+    int32_t monstermosCoarseBlockSize;
 };
 
 struct AtmosConfig
@@ -151,6 +183,9 @@ struct AtmosConfig
     float spacingEscapeRatio;
     float spacingMinGas;
     float spacingMaxWind;
+    uint8_t parallelLindaEnabled;
+    uint8_t monstermosCoarseEnabled;
+    uint8_t padding[2];
 };
 
 struct AtmosResult
@@ -166,11 +201,63 @@ struct AtmosResult
     uint8_t padding[3];
 };
 
+struct AtmosStats
+{
+    int64_t phaseNanoseconds[ATMOS_PHASE_COUNT];
+    int64_t totalNanoseconds;
+    int32_t ticks;
+    int32_t tilesProcessed;
+    int32_t hotspotsProcessed;
+    int32_t superconductTilesProcessed;
+    int32_t monstermosZones;
+    int32_t monstermosZoneTiles;
+    int32_t monstermosLargestZone;
+    int32_t monstermosZoneCacheHits;
+    int32_t monstermosCoarseZones;
+    int32_t depressurizations;
+    int32_t depressurizeCacheHits;
+    int32_t groupMerges;
+    int32_t groupBreakdowns;
+    int32_t groupDismantles;
+    int32_t groupSleeps;
+    int32_t groupWakes;
+    int32_t windEvents;
+    int32_t reactionsTriggered;
+    int32_t reactionCounts[ATMOS_REACTION_MAX_COUNT];
+};
+
+struct AtmosReactionDefinition
+{
+    float reactants[ATMOS_GAS_ARRAY_SIZE];
+    float products[ATMOS_GAS_ARRAY_SIZE];
+    float minimumTemperature;
+    float maximumTemperature;
+    float rateCoefficient;
+    float rateTemperatureScale;
+    float energyReleased;
+    int32_t rateFormula;
+    int32_t priority;
+};
+
+struct AtmosWindEvent
+{
+    int32_t tileIndex;
+    int32_t direction;
+    float pressureDifference;
+};
+
+struct LindaPassScratch;
+struct MonstermosScratch;
+
 struct GridAtmosState
 {
     TileAtmosData* tiles;
     int32_t tileCount;
     int32_t tileCapacity;
+    int32_t tileReservation;
+    uint32_t layoutGeneration;
+    uint32_t topologyGeneration;
+    int32_t gasCount;
 
     int32_t* activeTiles;
     int32_t activeTileCount;
@@ -188,9 +275,37 @@ struct GridAtmosState
     ExcitedGroupData* excitedGroups;
     int32_t excitedGroupCount;
     int32_t excitedGroupCapacity;
+    int32_t freeExcitedGroup;
+    int32_t* groupTileNext;
+    int32_t* groupTilePrev;
 
     int32_t updateCounter;
     int64_t equalizationQueueCycle;
+
+    LindaPassScratch* lindaScratch;
+
+    int32_t* activeSlots;
+    int32_t* hotspotSlots;
+    int32_t* superconductSlots;
+    int32_t* highPressureSlots;
+    int32_t hotspotTileCapacity;
+    int32_t superconductTileCapacity;
+    int32_t highPressureTileCapacity;
+
+    MonstermosScratch* monstermosScratch;
+
+    int32_t processPhase;
+    int32_t processCursor;
+
+    int32_t* archivedEpochs;
+    int32_t archiveEpoch;
+
+    AtmosWindEvent* windEvents;
+    int32_t windEventCount;
+    int32_t windEventCapacity;
+
+    AtmosStats stats;
+    uint64_t phaseTicks[ATMOS_PHASE_COUNT];
 };
 
 inline void atmos_constants_init_default(AtmosConstants* c)
@@ -243,14 +358,17 @@ inline void atmos_constants_init_default(AtmosConstants* c)
 
     c->excitedGroupBreakdownCycles = 4;
     c->excitedGroupsDismantleCycles = 16;
+    c->excitedGroupSleepCycles = 2;
     c->monstermosHardTileLimit = 2000;
     c->monstermosTileLimit = 200;
+    c->monstermosCoarseTileLimit = 65536;
+    c->monstermosCoarseBlockSize = 8;
 }
 
 inline float tile_total_moles(const TileAtmosData* tile)
 {
     float total = 0.0f;
-    for (int i = 0; i < ATMOS_GAS_COUNT; i++)
+    for (int i = 0; i < ATMOS_GAS_ARRAY_SIZE; i++)
         total += tile->moles[i];
     return total;
 }
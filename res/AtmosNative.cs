@@ -32,6 +32,14 @@ public static class AtmosDirection
     public const byte BitAll = 0x0F;
 }
 
+public static class AtmosSimdLevel
+{
+    public const uint Sse2 = 0;
+    public const uint Sse41 = 1;
+    public const uint Avx2 = 2;
+    public const uint Avx512 = 3;
+}
+
 public static class TileFlags
 {
     public const byte Space = 1 << 0;
@@ -130,8 +138,11 @@ public struct AtmosConstants
 
     public int ExcitedGroupBreakdownCycles;
     public int ExcitedGroupsDismantleCycles;
+    public int ExcitedGroupSleepCycles;
     public int MonstermosHardTileLimit;
     public int MonstermosTileLimit;
+    public int MonstermosCoarseTileLimit;
+    public int MonstermosCoarseBlockSize;
 }
 
 [StructLayout(LayoutKind.Sequential, Pack = 1)]
@@ -149,6 +160,9 @@ public unsafe struct AtmosConfig
     public float SpacingEscapeRatio;
     public float SpacingMinGas;
     public float SpacingMaxWind;
+    public byte ParallelLindaEnabled;
+    public byte MonstermosCoarseEnabled;
+    public fixed byte Padding[2];
 }
 
 [StructLayout(LayoutKind.Sequential)]
@@ -167,6 +181,74 @@ public struct AtmosResult
     public byte Padding3;
 }
 
+public static class AtmosReactionType
+{
+    public const int PlasmaFire = 0;
+    public const int TritiumFire = 1;
+    public const int FrezonProduction = 2;
+    public const int FrezonCoolant = 3;
+    public const int WaterVapor = 4;
+    public const int N2ODecomposition = 5;
+    public const int AmmoniaOxygen = 6;
+    public const int Count = 7;
+    public const int MaxCount = 16;
+}
+
+public static class AtmosReactionRate
+{
+    public const int Constant = 0;
+    public const int Limiting = 1;
+    public const int TemperatureScaled = 2;
+}
+
+[StructLayout(LayoutKind.Sequential)]
+public unsafe struct AtmosStats
+{
+    public fixed long PhaseNanoseconds[6];
+    public long TotalNanoseconds;
+    public int Ticks;
+    public int TilesProcessed;
+    public int HotspotsProcessed;
+    public int SuperconductTilesProcessed;
+    public int MonstermosZones;
+    public int MonstermosZoneTiles;
+    public int MonstermosLargestZone;
+    public int MonstermosZoneCacheHits;
+    public int MonstermosCoarseZones;
+    public int Depressurizations;
+    public int DepressurizeCacheHits;
+    public int GroupMerges;
+    public int GroupBreakdowns;
+    public int GroupDismantles;
+    public int GroupSleeps;
+    public int GroupWakes;
+    public int WindEvents;
+    public int ReactionsTriggered;
+    public fixed int ReactionCounts[AtmosReactionType.MaxCount];
+}
+
+[StructLayout(LayoutKind.Sequential)]
+public unsafe struct AtmosReactionDefinition
+{
+    public fixed float Reactants[12];
+    public fixed float Products[12];
+    public float MinimumTemperature;
+    public float MaximumTemperature;
+    public float RateCoefficient;
+    public float RateTemperatureScale;
+    public float EnergyReleased;
+    public int RateFormula;
+    public int Priority;
+}
+
+[StructLayout(LayoutKind.Sequential)]
+public struct AtmosWindEvent
+{
+    public int TileIndex;
+    public int Direction;
+    public float PressureDifference;
+}
+
 public static unsafe class AtmosNative
 {
     private const string LibName = "atmos_native";
@@ -180,6 +262,9 @@ public static unsafe class AtmosNative
     [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
     public static extern IntPtr atmos_create_grid(int initialCapacity);
 
+    [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+    public static extern IntPtr atmos_create_grid_ex(int initialCapacity, int gasCount);
+
     [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
     public static extern void atmos_destroy_grid(IntPtr state);
 
@@ -189,6 +274,15 @@ public static unsafe class AtmosNative
     [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
     public static extern int atmos_add_tile(IntPtr state, TileAtmosData* tile);
 
+    [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+    public static extern int atmos_add_tiles(IntPtr state, TileAtmosData* tiles, int count, int* outIndices, byte buildAdjacency);
+
+    [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+    public static extern void atmos_build_adjacency(IntPtr state);
+
+    [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+    public static extern int atmos_optimize_layout(IntPtr state, int* outRemap);
+
     [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
     public static extern void atmos_update_tile(IntPtr state, int index, TileAtmosData* tile);
 
@@ -207,6 +301,18 @@ public static unsafe class AtmosNative
     [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
     public static extern AtmosResult atmos_process(IntPtr state, AtmosConfig* config);
 
+    [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+    public static extern void atmos_process_many(IntPtr* grids, int count, AtmosConfig* config, AtmosResult* results);
+
+    [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+    public static extern int atmos_set_worker_threads(int threads);
+
+    [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+    public static extern int atmos_get_worker_threads();
+
+    [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+    public static extern void atmos_shutdown();
+
     [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
     public static extern AtmosResult atmos_process_revalidate(IntPtr state, AtmosConfig* config);
 
@@ -225,6 +331,9 @@ public static unsafe class AtmosNative
     [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
     public static extern AtmosResult atmos_process_high_pressure(IntPtr state, AtmosConfig* config);
 
+    [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+    public static extern int atmos_get_wind_events(IntPtr state, AtmosWindEvent** events);
+
     [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
     public static extern AtmosResult atmos_equalize_pressure_zone(IntPtr state, int startTile, AtmosConfig* config);
 
@@ -246,6 +355,14 @@ public static unsafe class AtmosNative
     [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
     public static extern float atmos_get_thermal_energy(TileAtmosData* tile, float* specificHeats);
 
+    [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+    public static extern int atmos_query_tiles(IntPtr state, int* tileIndices, int count, AtmosConfig* config,
+        float* heatCapacity, float* pressure, float* totalMoles, float* thermalEnergy);
+
+    [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+    public static extern int atmos_query_grid(IntPtr state, AtmosConfig* config,
+        float* heatCapacity, float* pressure, float* totalMoles, float* thermalEnergy);
+
     [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
     public static extern void atmos_merge(TileAtmosData* receiver, TileAtmosData* giver, float* specificHeats);
 
@@ -258,6 +375,15 @@ public static unsafe class AtmosNative
     [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
     public static extern int atmos_react(TileAtmosData* tile, AtmosConfig* config);
 
+    [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+    public static extern int atmos_register_reaction(AtmosReactionDefinition* definition);
+
+    [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+    public static extern int atmos_reset_reactions();
+
+    [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+    public static extern int atmos_get_reaction_count();
+
     [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
     public static extern void atmos_share(TileAtmosData* receiver, TileAtmosData* sharer, int adjacentCount, AtmosConfig* config);
 
@@ -267,15 +393,27 @@ public static unsafe class AtmosNative
     [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
     public static extern void atmos_config_init_default(AtmosConfig* config);
 
+    [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+    public static extern void atmos_get_stats(IntPtr state, AtmosStats* stats, byte reset);
+
     [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
     public static extern int atmos_get_active_tile_count(IntPtr state);
 
+    [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+    public static extern int atmos_get_gas_count(IntPtr state);
+
     [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
     public static extern int atmos_get_tile_count(IntPtr state);
 
     [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
     public static extern TileAtmosData* atmos_get_tiles_ptr(IntPtr state);
 
+    [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+    public static extern int atmos_reserve_tile_storage(IntPtr state, int maxTiles);
+
+    [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+    public static extern uint atmos_get_layout_generation(IntPtr state);
+
     [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
     public static extern void atmos_archive_tile(TileAtmosData* tile);
 
@@ -3,23 +3,51 @@
 #include "atmos_internal.h"
 #include <stdlib.h>
 #include <string.h>
-#include <chrono>
 
 #define ATMOS_VERSION 1
+#define ATMOS_MANY_BATCH_WEIGHT 2048
 
-static int g_simdLevel = -1;
+struct ProcessManyContext
+{
+    GridAtmosState** grids;
+    const AtmosConfig* config;
+    AtmosResult* results;
+    const int32_t* order;
+    const int32_t* taskStart;
+};
 
-static int detect_simd_level()
+struct ManyGridEntry
 {
-#if defined(__AVX512F__)
-    return 3;
-#elif defined(__AVX2__)
-    return 2;
-#elif defined(__SSE4_1__)
-    return 1;
-#else
-    return 0;
-#endif
+    const GridAtmosState* grid;
+    int32_t index;
+};
+
+static int many_grid_compare(const void* a, const void* b)
+{
+    const ManyGridEntry* left = (const ManyGridEntry*)a;
+    const ManyGridEntry* right = (const ManyGridEntry*)b;
+    if (left->grid != right->grid)
+        return left->grid < right->grid ? -1 : 1;
+    return left->index - right->index;
+}
+
+static int32_t grid_weight(const GridAtmosState* state)
+{
+    return state->activeTileCount + state->hotspotTileCount + state->superconductTileCount + 1;
+}
+
+static void process_many_tasks(void* context, int32_t begin, int32_t end)
+{
+    ProcessManyContext* many = (ProcessManyContext*)context;
+
+    for (int32_t task = begin; task < end; task++)
+    {
+        for (int32_t i = many->taskStart[task]; i < many->taskStart[task + 1]; i++)
+        {
+            int32_t gridIndex = many->order[i];
+            many->results[gridIndex] = atmos_process(many->grids[gridIndex], many->config);
+        }
+    }
 }
 
 extern "C"
@@ -32,19 +60,31 @@ ATMOS_API uint32_t atmos_get_version()
 
 ATMOS_API uint32_t atmos_get_simd_level()
 {
-    if (g_simdLevel < 0)
-        g_simdLevel = detect_simd_level();
-    return g_simdLevel;
+    return atmos_kernel_table()->simdLevel;
+}
+
+static bool is_supported_gas_count(int32_t gasCount)
+{
+    return gasCount == 8 || gasCount == ATMOS_GAS_COUNT || gasCount == ATMOS_GAS_ARRAY_SIZE;
 }
 
 ATMOS_API GridAtmosState* atmos_create_grid(int32_t initialCapacity)
 {
+    return atmos_create_grid_ex(initialCapacity, ATMOS_GAS_COUNT);
+}
+
+ATMOS_API GridAtmosState* atmos_create_grid_ex(int32_t initialCapacity, int32_t gasCount)
+{
+    if (!is_supported_gas_count(gasCount))
+        return nullptr;
+
     if (initialCapacity < 64)
         initialCapacity = 64;
 
     GridAtmosState* state = (GridAtmosState*)calloc(1, sizeof(GridAtmosState));
     if (!state) return nullptr;
 
+    state->gasCount = gasCount;
     state->tileCapacity = initialCapacity;
     state->tiles = (TileAtmosData*)calloc(initialCapacity, sizeof(TileAtmosData));
     if (!state->tiles)
@@ -56,12 +96,35 @@ ATMOS_API GridAtmosState* atmos_create_grid(int32_t initialCapacity)
     state->activeTileCapacity = initialCapacity;
     state->activeTiles = (int32_t*)malloc(initialCapacity * sizeof(int32_t));
 
+    state->hotspotTileCapacity = initialCapacity;
     state->hotspotTiles = (int32_t*)malloc(initialCapacity * sizeof(int32_t));
+    state->superconductTileCapacity = initialCapacity;
     state->superconductTiles = (int32_t*)malloc(initialCapacity * sizeof(int32_t));
+    state->highPressureTileCapacity = initialCapacity;
     state->highPressureTiles = (int32_t*)malloc(initialCapacity * sizeof(int32_t));
 
+    state->activeSlots = (int32_t*)malloc(initialCapacity * sizeof(int32_t));
+    state->hotspotSlots = (int32_t*)malloc(initialCapacity * sizeof(int32_t));
+    state->superconductSlots = (int32_t*)malloc(initialCapacity * sizeof(int32_t));
+    state->highPressureSlots = (int32_t*)malloc(initialCapacity * sizeof(int32_t));
+    memset(state->activeSlots, 0xFF, initialCapacity * sizeof(int32_t));
+    memset(state->hotspotSlots, 0xFF, initialCapacity * sizeof(int32_t));
+    memset(state->superconductSlots, 0xFF, initialCapacity * sizeof(int32_t));
+    memset(state->highPressureSlots, 0xFF, initialCapacity * sizeof(int32_t));
+
+    state->archivedEpochs = (int32_t*)calloc(initialCapacity, sizeof(int32_t));
+
+    state->windEventCapacity = initialCapacity;
+    state->windEvents = (AtmosWindEvent*)malloc(initialCapacity * sizeof(AtmosWindEvent));
+
     state->excitedGroupCapacity = 256;
     state->excitedGroups = (ExcitedGroupData*)calloc(256, sizeof(ExcitedGroupData));
+    state->freeExcitedGroup = -1;
+
+    state->groupTileNext = (int32_t*)malloc(initialCapacity * sizeof(int32_t));
+    state->groupTilePrev = (int32_t*)malloc(initialCapacity * sizeof(int32_t));
+    memset(state->groupTileNext, 0xFF, initialCapacity * sizeof(int32_t));
+    memset(state->groupTilePrev, 0xFF, initialCapacity * sizeof(int32_t));
 
     state->updateCounter = 1;
     state->equalizationQueueCycle = 0;
@@ -74,7 +137,7 @@ ATMOS_API void atmos_destroy_grid(GridAtmosState* state)
     if (!state) return;
 
     if (state->tiles)
-        free(state->tiles);
+        release_tile_storage(state);
 
     if (state->activeTiles)
         free(state->activeTiles);
@@ -88,15 +151,19 @@ ATMOS_API void atmos_destroy_grid(GridAtmosState* state)
     if (state->highPressureTiles)
         free(state->highPressureTiles);
 
-    if (state->excitedGroups)
-    {
-        for (int i = 0; i < state->excitedGroupCount; i++)
-        {
-            if (state->excitedGroups[i].tileIndices)
-                free(state->excitedGroups[i].tileIndices);
-        }
-        free(state->excitedGroups);
-    }
+    free(state->activeSlots);
+    free(state->hotspotSlots);
+    free(state->superconductSlots);
+    free(state->highPressureSlots);
+    free(state->archivedEpochs);
+    free(state->windEvents);
+
+    free(state->excitedGroups);
+    free(state->groupTileNext);
+    free(state->groupTilePrev);
+
+    free_linda_scratch(state);
+    free_monstermos_scratch(state);
 
     free(state);
 }
@@ -110,36 +177,96 @@ ATMOS_API void atmos_reset_grid(GridAtmosState* state)
     state->hotspotTileCount = 0;
     state->superconductTileCount = 0;
     state->highPressureTileCount = 0;
+    state->windEventCount = 0;
 
-    for (int i = 0; i < state->excitedGroupCount; i++)
-    {
-        if (state->excitedGroups[i].tileIndices)
-        {
-            free(state->excitedGroups[i].tileIndices);
-            state->excitedGroups[i].tileIndices = nullptr;
-        }
-    }
     state->excitedGroupCount = 0;
+    state->freeExcitedGroup = -1;
+    state->layoutGeneration++;
 
     state->updateCounter = 1;
     state->equalizationQueueCycle = 0;
+    state->processPhase = ATMOS_PHASE_ARCHIVE;
+    state->processCursor = 0;
+
+    memset(&state->stats, 0, sizeof(AtmosStats));
+    memset(state->phaseTicks, 0, sizeof(state->phaseTicks));
 }
 
 ATMOS_API int32_t atmos_add_tile(GridAtmosState* state, const TileAtmosData* tile)
 {
     if (!state || !tile) return -1;
 
-    ensure_tile_capacity(state, state->tileCount + 1);
+    if (!ensure_tile_capacity(state, state->tileCount + 1)) return -1;
 
     int32_t index = state->tileCount++;
     memcpy(&state->tiles[index], tile, sizeof(TileAtmosData));
+    clear_unused_gases(state, &state->tiles[index]);
+    state->groupTileNext[index] = -1;
+    state->groupTilePrev[index] = -1;
+    state->topologyGeneration++;
     return index;
 }
 
+ATMOS_API int32_t atmos_add_tiles(GridAtmosState* state, const TileAtmosData* tiles, int32_t count, int32_t* outIndices, uint8_t buildAdjacency)
+{
+    if (!state || !tiles || count <= 0) return -1;
+
+    if (!ensure_tile_capacity(state, state->tileCount + count)) return -1;
+
+    int32_t first = state->tileCount;
+    memcpy(&state->tiles[first], tiles, count * sizeof(TileAtmosData));
+    state->tileCount += count;
+    state->topologyGeneration++;
+
+    for (int32_t i = first; i < state->tileCount; i++)
+    {
+        clear_unused_gases(state, &state->tiles[i]);
+        state->groupTileNext[i] = -1;
+        state->groupTilePrev[i] = -1;
+    }
+
+    if (outIndices)
+    {
+        for (int32_t i = 0; i < count; i++)
+            outIndices[i] = first + i;
+    }
+
+    if (buildAdjacency)
+        build_tile_adjacency(state, first, state->tileCount);
+
+    return first;
+}
+
+ATMOS_API void atmos_build_adjacency(GridAtmosState* state)
+{
+    if (!state) return;
+    build_tile_adjacency(state, 0, state->tileCount);
+}
+
+ATMOS_API int32_t atmos_optimize_layout(GridAtmosState* state, int32_t* outRemap)
+{
+    if (!state) return 0;
+    if (state->processPhase != ATMOS_PHASE_ARCHIVE || state->processCursor != 0) return 0;
+
+    return optimize_tile_layout(state, outRemap) ? 1 : 0;
+}
+
 ATMOS_API void atmos_update_tile(GridAtmosState* state, int32_t index, const TileAtmosData* tile)
 {
     if (!state || !tile || index < 0 || index >= state->tileCount) return;
-    memcpy(&state->tiles[index], tile, sizeof(TileAtmosData));
+
+    TileAtmosData* current = &state->tiles[index];
+    if (current->adjacentBits != tile->adjacentBits || current->blockedBits != tile->blockedBits ||
+        ((current->flags ^ tile->flags) & TILE_FLAG_SPACE) ||
+        memcmp(current->adjacentIndices, tile->adjacentIndices, sizeof(current->adjacentIndices)) != 0)
+        state->topologyGeneration++;
+
+    int32_t groupId = current->excitedGroupId;
+    memcpy(current, tile, sizeof(TileAtmosData));
+    clear_unused_gases(state, &state->tiles[index]);
+
+    if (groupId >= 0)
+        wake_excited_group(state, groupId);
 }
 
 ATMOS_API TileAtmosData* atmos_get_tile(GridAtmosState* state, int32_t index)
@@ -154,12 +281,17 @@ ATMOS_API void atmos_set_adjacency(GridAtmosState* state, int32_t tileIndex, int
     if (direction < 0 || direction >= ATMOS_DIRECTIONS) return;
 
     TileAtmosData* tile = &state->tiles[tileIndex];
+    uint8_t adjacentBits = tile->adjacentBits;
+    int32_t previousIndex = tile->adjacentIndices[direction];
     tile->adjacentIndices[direction] = adjacentIndex;
 
     if (adjacentIndex >= 0)
         tile->adjacentBits |= (1 << direction);
     else
         tile->adjacentBits &= ~(1 << direction);
+
+    if (tile->adjacentBits != adjacentBits || previousIndex != adjacentIndex)
+        state->topologyGeneration++;
 }
 
 ATMOS_API void atmos_add_active_tile(GridAtmosState* state, int32_t tileIndex)
@@ -177,35 +309,98 @@ ATMOS_API AtmosResult atmos_process(GridAtmosState* state, const AtmosConfig* co
     AtmosResult result = {};
     if (!state || !config) return result;
 
-    auto startTime = std::chrono::high_resolution_clock::now();
+    return process_tick(state, config);
+}
 
-    state->updateCounter++;
+ATMOS_API void atmos_process_many(GridAtmosState** grids, int32_t count, const AtmosConfig* config, AtmosResult* results)
+{
+    if (!grids || !config || !results || count <= 0) return;
 
-    AtmosResult activeResult = atmos_process_active_tiles(state, config);
-    result.tilesProcessed += activeResult.tilesProcessed;
+    int32_t* order = (int32_t*)malloc(count * sizeof(int32_t));
+    int32_t* weights = (int32_t*)malloc(count * sizeof(int32_t));
+    int32_t* taskStart = (int32_t*)malloc((count + 1) * sizeof(int32_t));
+    int32_t* firstIndex = (int32_t*)malloc(count * sizeof(int32_t));
+    ManyGridEntry* entries = (ManyGridEntry*)malloc(count * sizeof(ManyGridEntry));
 
-    if (config->excitedGroupsEnabled)
+    for (int32_t i = 0; i < count; i++)
     {
-        AtmosResult groupResult = atmos_process_excited_groups(state, config);
-        result.excitedGroupsCount = groupResult.excitedGroupsCount;
+        entries[i].grid = grids[i];
+        entries[i].index = i;
     }
+    qsort(entries, count, sizeof(ManyGridEntry), many_grid_compare);
 
-    AtmosResult hotspotResult = atmos_process_hotspots(state, config);
-    result.hotspotTilesCount = hotspotResult.hotspotTilesCount;
+    for (int32_t i = 0; i < count; i++)
+    {
+        bool repeat = i > 0 && entries[i].grid == entries[i - 1].grid;
+        firstIndex[entries[i].index] = repeat ? firstIndex[entries[i - 1].index] : entries[i].index;
+    }
 
-    if (config->superconductionEnabled)
+    int32_t gridCount = 0;
+    for (int32_t i = 0; i < count; i++)
     {
-        AtmosResult superResult = atmos_process_superconductivity(state, config);
-        result.superconductTilesCount = superResult.superconductTilesCount;
+        results[i] = AtmosResult{};
+        if (!grids[i] || firstIndex[i] != i)
+            continue;
+
+        weights[i] = grid_weight(grids[i]);
+
+        int32_t slot = gridCount++;
+        while (slot > 0 && weights[order[slot - 1]] < weights[i])
+        {
+            order[slot] = order[slot - 1];
+            slot--;
+        }
+        order[slot] = i;
     }
 
-    AtmosResult hpResult = atmos_process_high_pressure(state, config);
-    result.maxPressureDelta = hpResult.maxPressureDelta;
+    int32_t taskCount = 0;
+    int32_t batchWeight = 0;
+    for (int32_t i = 0; i < gridCount; i++)
+    {
+        if (batchWeight == 0)
+            taskStart[taskCount++] = i;
 
-    result.activeTilesCount = state->activeTileCount;
-    result.processingComplete = 1;
+        batchWeight += weights[order[i]];
+        if (batchWeight >= ATMOS_MANY_BATCH_WEIGHT)
+            batchWeight = 0;
+    }
+    taskStart[taskCount] = gridCount;
 
-    return result;
+    ProcessManyContext many;
+    many.grids = grids;
+    many.config = config;
+    many.results = results;
+    many.order = order;
+    many.taskStart = taskStart;
+
+    thread_pool_parallel_for(taskCount, 1, process_many_tasks, &many);
+
+    for (int32_t i = 0; i < count; i++)
+    {
+        if (firstIndex[i] != i)
+            results[i] = results[firstIndex[i]];
+    }
+
+    free(order);
+    free(weights);
+    free(taskStart);
+    free(firstIndex);
+    free(entries);
+}
+
+ATMOS_API int32_t atmos_set_worker_threads(int32_t threads)
+{
+    return thread_pool_set_size(threads) ? 1 : 0;
+}
+
+ATMOS_API int32_t atmos_get_worker_threads(void)
+{
+    return thread_pool_get_size();
+}
+
+ATMOS_API void atmos_shutdown(void)
+{
+    thread_pool_stop();
 }
 
 ATMOS_API AtmosResult atmos_process_revalidate(GridAtmosState* state, const AtmosConfig* config)
@@ -222,49 +417,20 @@ ATMOS_API AtmosResult atmos_process_active_tiles(GridAtmosState* state, const At
     AtmosResult result = {};
     if (!state || !config) return result;
 
-    auto startTime = std::chrono::high_resolution_clock::now();
-    int checkInterval = 30;
+    AtmosBudget budget;
+    budget_start(&budget, config->maxProcessTimeMicroseconds);
 
-    for (int i = 0; i < state->tileCount; i++)
-    {
-        TileAtmosData* tile = &state->tiles[i];
-        if (tile->flags & TILE_FLAG_IMMUTABLE)
-            continue;
+    int32_t reactionsBefore = state->stats.reactionsTriggered;
 
-        archive_tile(tile);
-    }
+    int32_t cursor = 0;
+    run_archive_phase(state, &cursor, nullptr);
 
-    int processed = 0;
-    for (int i = 0; i < state->activeTileCount; i++)
-    {
-        int32_t tileIndex = state->activeTiles[i];
-        if (tileIndex < 0 || tileIndex >= state->tileCount)
-            continue;
-
-        if (config->monstermosEnabled)
-        {
-            equalize_pressure_in_zone(state, tileIndex, config);
-        }
-
-        process_cell(state, tileIndex, config);
-        processed++;
-
-        if (processed % checkInterval == 0)
-        {
-            auto elapsed = std::chrono::high_resolution_clock::now() - startTime;
-            auto us = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
-            if (us > config->maxProcessTimeMicroseconds)
-            {
-                result.processingComplete = 0;
-                break;
-            }
-        }
-    }
+    bool complete = run_active_phase(state, config, &cursor, &budget, &result);
 
-    result.tilesProcessed = processed;
+    state->stats.tilesProcessed += result.tilesProcessed;
+    result.reactionsTriggered = state->stats.reactionsTriggered - reactionsBefore;
     result.activeTilesCount = state->activeTileCount;
-    result.processingComplete = 1;
-
+    result.processingComplete = complete ? 1 : 0;
     return result;
 }
 
@@ -273,23 +439,8 @@ ATMOS_API AtmosResult atmos_process_excited_groups(GridAtmosState* state, const
     AtmosResult result = {};
     if (!state || !config) return result;
 
-    for (int i = 0; i < state->excitedGroupCount; i++)
-    {
-        ExcitedGroupData* group = &state->excitedGroups[i];
-        if (group->disposed) continue;
-
-        group->breakdownCooldown++;
-        group->dismantleCooldown++;
-
-        if (group->breakdownCooldown > config->constants.excitedGroupBreakdownCycles)
-        {
-            excited_group_self_breakdown(state, i, config);
-        }
-        else if (group->dismantleCooldown > config->constants.excitedGroupsDismantleCycles)
-        {
-            deactivate_group_tiles(state, i);
-        }
-    }
+    int32_t cursor = 0;
+    run_excited_groups_phase(state, config, &cursor, nullptr);
 
     result.excitedGroupsCount = state->excitedGroupCount;
     result.processingComplete = 1;
@@ -301,11 +452,8 @@ ATMOS_API AtmosResult atmos_process_hotspots(GridAtmosState* state, const AtmosC
     AtmosResult result = {};
     if (!state || !config) return result;
 
-    for (int i = 0; i < state->hotspotTileCount; i++)
-    {
-        int32_t tileIndex = state->hotspotTiles[i];
-        process_hotspot(state, tileIndex, config);
-    }
+    int32_t cursor = 0;
+    run_hotspot_phase(state, config, &cursor, nullptr);
 
     result.hotspotTilesCount = state->hotspotTileCount;
     result.processingComplete = 1;
@@ -317,11 +465,8 @@ ATMOS_API AtmosResult atmos_process_superconductivity(GridAtmosState* state, con
     AtmosResult result = {};
     if (!state || !config) return result;
 
-    for (int i = 0; i < state->superconductTileCount; i++)
-    {
-        int32_t tileIndex = state->superconductTiles[i];
-        superconduct(state, tileIndex, config);
-    }
+    int32_t cursor = 0;
+    run_superconduct_phase(state, config, &cursor, nullptr);
 
     result.superconductTilesCount = state->superconductTileCount;
     result.processingComplete = 1;
@@ -333,25 +478,40 @@ ATMOS_API AtmosResult atmos_process_high_pressure(GridAtmosState* state, const A
     AtmosResult result = {};
     if (!state || !config) return result;
 
-    float maxDelta = 0.0f;
-    for (int i = 0; i < state->highPressureTileCount; i++)
-    {
-        int32_t tileIndex = state->highPressureTiles[i];
-        TileAtmosData* tile = &state->tiles[tileIndex];
+    int32_t cursor = 0;
+    run_high_pressure_phase(state, config, &cursor, nullptr, &result);
 
-        high_pressure_movements(state, tileIndex, config);
+    result.processingComplete = 1;
+    return result;
+}
 
-        if (tile->pressureDifference > maxDelta)
-            maxDelta = tile->pressureDifference;
+ATMOS_API void atmos_get_stats(GridAtmosState* state, AtmosStats* stats, uint8_t reset)
+{
+    if (!state || !stats) return;
+
+    *stats = state->stats;
+    stats->totalNanoseconds = 0;
 
-        tile->pressureDifference = 0.0f;
-        tile->currentTransferDirection = -1;
+    for (int i = 0; i < ATMOS_PHASE_COUNT; i++)
+    {
+        stats->phaseNanoseconds[i] = stats_clock_to_ns(state->phaseTicks[i]);
+        stats->totalNanoseconds += stats->phaseNanoseconds[i];
     }
 
-    state->highPressureTileCount = 0;
-    result.maxPressureDelta = maxDelta;
-    result.processingComplete = 1;
-    return result;
+    if (reset)
+    {
+        memset(&state->stats, 0, sizeof(AtmosStats));
+        memset(state->phaseTicks, 0, sizeof(state->phaseTicks));
+    }
+}
+
+ATMOS_API int32_t atmos_get_wind_events(const GridAtmosState* state, const AtmosWindEvent** events)
+{
+    if (events) *events = nullptr;
+    if (!state) return 0;
+
+    if (events) *events = state->windEvents;
+    return state->windEventCount;
 }
 
 ATMOS_API AtmosResult atmos_equalize_pressure_zone(GridAtmosState* state, int32_t startTile, const AtmosConfig* config)
@@ -395,14 +555,7 @@ ATMOS_API void atmos_extinguish_hotspot(GridAtmosState* state, int32_t tileIndex
     tile->hotspotState = 0;
     tile->flags &= ~TILE_FLAG_HOTSPOT;
 
-    for (int i = 0; i < state->hotspotTileCount; i++)
-    {
-        if (state->hotspotTiles[i] == tileIndex)
-        {
-            state->hotspotTiles[i] = state->hotspotTiles[--state->hotspotTileCount];
-            break;
-        }
-    }
+    tile_set_remove(state->hotspotTiles, &state->hotspotTileCount, state->hotspotSlots, tileIndex);
 }
 
 ATMOS_API float atmos_get_heat_capacity(const TileAtmosData* tile, const float* specificHeats)
@@ -423,6 +576,31 @@ ATMOS_API float atmos_get_thermal_energy(const TileAtmosData* tile, const float*
     return get_thermal_energy_impl(tile, specificHeats);
 }
 
+ATMOS_API int32_t atmos_query_tiles(const GridAtmosState* state, const int32_t* tileIndices, int32_t count, const AtmosConfig* config,
+                                    float* heatCapacity, float* pressure, float* totalMoles, float* thermalEnergy)
+{
+    if (!state || !tileIndices || !config || count <= 0) return 0;
+
+    for (int32_t i = 0; i < count; i++)
+    {
+        if (tileIndices[i] < 0 || tileIndices[i] >= state->tileCount) return 0;
+    }
+
+    TileQueryOutputs outputs = { heatCapacity, pressure, totalMoles, thermalEnergy };
+    atmos_kernel_table()->queryTiles(state->tiles, tileIndices, count, config, &outputs);
+    return count;
+}
+
+ATMOS_API int32_t atmos_query_grid(const GridAtmosState* state, const AtmosConfig* config,
+                                   float* heatCapacity, float* pressure, float* totalMoles, float* thermalEnergy)
+{
+    if (!state || !config) return 0;
+
+    TileQueryOutputs outputs = { heatCapacity, pressure, totalMoles, thermalEnergy };
+    atmos_kernel_table()->queryTiles(state->tiles, nullptr, state->tileCount, config, &outputs);
+    return state->tileCount;
+}
+
 ATMOS_API void atmos_merge(TileAtmosData* receiver, const TileAtmosData* giver, const float* specificHeats)
 {
     if (!receiver || !giver || !specificHeats) return;
@@ -449,6 +627,24 @@ ATMOS_API int32_t atmos_react(TileAtmosData* tile, const AtmosConfig* config)
     return react_impl(tile, config);
 }
 
+ATMOS_API int32_t atmos_register_reaction(const AtmosReactionDefinition* definition)
+{
+    if (thread_pool_busy()) return -1;
+    return register_reaction(definition);
+}
+
+ATMOS_API int32_t atmos_reset_reactions(void)
+{
+    if (thread_pool_busy()) return 0;
+    reset_reactions();
+    return 1;
+}
+
+ATMOS_API int32_t atmos_get_reaction_count(void)
+{
+    return reaction_count();
+}
+
 ATMOS_API void atmos_share(TileAtmosData* receiver, TileAtmosData* sharer, int32_t adjacentCount, const AtmosConfig* config)
 {
     if (!receiver || !sharer || !config) return;
@@ -496,6 +692,12 @@ ATMOS_API int32_t atmos_get_active_tile_count(const GridAtmosState* state)
     return state ? state->activeTileCount : 0;
 }
 
+ATMOS_API int32_t atmos_get_gas_count(const GridAtmosState* state)
+{
+    if (!state) return 0;
+    return state->gasCount;
+}
+
 ATMOS_API int32_t atmos_get_tile_count(const GridAtmosState* state)
 {
     return state ? state->tileCount : 0;
@@ -506,6 +708,17 @@ ATMOS_API TileAtmosData* atmos_get_tiles_ptr(GridAtmosState* state)
     return state ? state->tiles : nullptr;
 }
 
+ATMOS_API int32_t atmos_reserve_tile_storage(GridAtmosState* state, int32_t maxTiles)
+{
+    if (!state || state->tileReservation > 0 || maxTiles < state->tileCapacity) return 0;
+    return reserve_tile_storage(state, maxTiles) ? 1 : 0;
+}
+
+ATMOS_API uint32_t atmos_get_layout_generation(const GridAtmosState* state)
+{
+    return state ? state->layoutGeneration : 0;
+}
+
 ATMOS_API void atmos_archive_tile(TileAtmosData* tile)
 {
     if (tile)
@@ -518,22 +731,121 @@ ATMOS_API void atmos_archive_all(GridAtmosState* state)
 
     for (int i = 0; i < state->tileCount; i++)
     {
+        clear_unused_gases(state, &state->tiles[i]);
         archive_tile(&state->tiles[i]);
     }
 }
 
 }
 
-void ensure_tile_capacity(GridAtmosState* state, int32_t needed)
+bool ensure_tile_capacity(GridAtmosState* state, int32_t needed)
 {
-    if (state->tileCapacity >= needed) return;
+    if (state->tileCapacity >= needed) return true;
 
     int32_t newCapacity = state->tileCapacity * 2;
     while (newCapacity < needed) newCapacity *= 2;
 
-    state->tiles = (TileAtmosData*)realloc(state->tiles, newCapacity * sizeof(TileAtmosData));
+    if (state->tileReservation > 0)
+    {
+        if (needed > state->tileReservation) return false;
+        if (newCapacity > state->tileReservation) newCapacity = state->tileReservation;
+        if (!commit_tile_storage(state, newCapacity)) return false;
+    }
+    else
+    {
+        state->tiles = (TileAtmosData*)realloc(state->tiles, newCapacity * sizeof(TileAtmosData));
+        state->layoutGeneration++;
+    }
+
     memset(state->tiles + state->tileCount, 0, (newCapacity - state->tileCount) * sizeof(TileAtmosData));
+
+    int32_t** slotArrays[6] = { &state->activeSlots, &state->hotspotSlots, &state->superconductSlots, &state->highPressureSlots,
+                                &state->groupTileNext, &state->groupTilePrev };
+    for (int i = 0; i < 6; i++)
+    {
+        *slotArrays[i] = (int32_t*)realloc(*slotArrays[i], newCapacity * sizeof(int32_t));
+        memset(*slotArrays[i] + state->tileCapacity, 0xFF, (newCapacity - state->tileCapacity) * sizeof(int32_t));
+    }
+
+    state->archivedEpochs = (int32_t*)realloc(state->archivedEpochs, newCapacity * sizeof(int32_t));
+    memset(state->archivedEpochs + state->tileCapacity, 0, (newCapacity - state->tileCapacity) * sizeof(int32_t));
+
     state->tileCapacity = newCapacity;
+    return true;
+}
+
+static uint32_t coordinate_hash(uint64_t key)
+{
+    key ^= key >> 33;
+    key *= 0xFF51AFD7ED558CCDull;
+    key ^= key >> 33;
+    return (uint32_t)key;
+}
+
+static uint64_t coordinate_key(int32_t x, int32_t y)
+{
+    return ((uint64_t)(uint32_t)x << 32) | (uint32_t)y;
+}
+
+static int32_t find_coordinate(const uint64_t* keys, const int32_t* values, uint32_t mask, int32_t x, int32_t y)
+{
+    uint64_t key = coordinate_key(x, y);
+    for (uint32_t slot = coordinate_hash(key) & mask; values[slot] >= 0; slot = (slot + 1) & mask)
+    {
+        if (keys[slot] == key)
+            return values[slot];
+    }
+    return -1;
+}
+
+void build_tile_adjacency(GridAtmosState* state, int32_t begin, int32_t end)
+{
+    static const int32_t offsets[ATMOS_DIRECTIONS][2] = { { 0, 1 }, { 0, -1 }, { 1, 0 }, { -1, 0 } };
+
+    uint32_t tableSize = 16;
+    while (tableSize < (uint32_t)state->tileCount * 2)
+        tableSize <<= 1;
+    uint32_t mask = tableSize - 1;
+
+    uint64_t* keys = (uint64_t*)malloc(tableSize * sizeof(uint64_t));
+    int32_t* values = (int32_t*)malloc(tableSize * sizeof(int32_t));
+    memset(values, 0xFF, tableSize * sizeof(int32_t));
+
+    for (int32_t i = 0; i < state->tileCount; i++)
+    {
+        uint64_t key = coordinate_key(state->tiles[i].gridX, state->tiles[i].gridY);
+        uint32_t slot = coordinate_hash(key) & mask;
+        while (values[slot] >= 0 && keys[slot] != key)
+            slot = (slot + 1) & mask;
+
+        if (values[slot] < 0)
+        {
+            keys[slot] = key;
+            values[slot] = i;
+        }
+    }
+
+    for (int32_t i = begin; i < end; i++)
+    {
+        TileAtmosData* tile = &state->tiles[i];
+
+        for (int dir = 0; dir < ATMOS_DIRECTIONS; dir++)
+        {
+            int32_t adjIndex = find_coordinate(keys, values, mask, tile->gridX + offsets[dir][0], tile->gridY + offsets[dir][1]);
+            int back = opposite_dir(dir);
+
+            if (adjIndex >= 0 && ((tile->blockedBits & (1 << dir)) || (state->tiles[adjIndex].blockedBits & (1 << back))))
+                adjIndex = -1;
+
+            atmos_set_adjacency(state, i, dir, adjIndex);
+
+            if (adjIndex >= 0 && (adjIndex < begin || adjIndex >= end))
+                atmos_set_adjacency(state, adjIndex, back, i);
+        }
+    }
+
+    free(keys);
+    free(values);
 }
 
 void ensure_active_capacity(GridAtmosState* state, int32_t needed)
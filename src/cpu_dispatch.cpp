@@ -0,0 +1,111 @@
+#include "atmos_kernel_table.h"
+#include <stdlib.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+ATMOS_DEFINE_KERNEL_TABLE(kernel_table_sse2)
+
+static void cpuid(uint32_t leaf, uint32_t subleaf, uint32_t regs[4])
+{
+#ifdef _MSC_VER
+    int out[4];
+    __cpuidex(out, (int)leaf, (int)subleaf);
+    for (int i = 0; i < 4; i++)
+        regs[i] = (uint32_t)out[i];
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+static uint64_t xgetbv0()
+{
+#ifdef _MSC_VER
+    return _xgetbv(0);
+#else
+    uint32_t eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return ((uint64_t)edx << 32) | eax;
+#endif
+}
+
+uint32_t detect_cpu_simd_level()
+{
+    uint32_t regs[4];
+
+    cpuid(0, 0, regs);
+    uint32_t maxLeaf = regs[0];
+
+    cpuid(1, 0, regs);
+    uint32_t ecx1 = regs[2];
+
+    if (!(ecx1 & (1u << 19)))
+        return ATMOS_SIMD_SSE2;
+
+    bool osxsave = (ecx1 & (1u << 27)) != 0;
+    bool avx = (ecx1 & (1u << 28)) != 0;
+    bool fma = (ecx1 & (1u << 12)) != 0;
+
+    if (!osxsave || !avx || !fma || maxLeaf < 7)
+        return ATMOS_SIMD_SSE41;
+
+    uint64_t xcr0 = xgetbv0();
+    if ((xcr0 & 0x6) != 0x6)
+        return ATMOS_SIMD_SSE41;
+
+    cpuid(7, 0, regs);
+    uint32_t ebx7 = regs[1];
+
+    if (!(ebx7 & (1u << 5)))
+        return ATMOS_SIMD_SSE41;
+
+    bool avx512f = (ebx7 & (1u << 16)) != 0;
+    bool avx512vl = (ebx7 & (1u << 31)) != 0;
+
+    if (avx512f && avx512vl && (xcr0 & 0xE6) == 0xE6)
+        return ATMOS_SIMD_AVX512;
+
+    return ATMOS_SIMD_AVX2;
+}
+
+const AtmosKernelTable* select_kernel_table(uint32_t level)
+{
+    switch (level)
+    {
+        case ATMOS_SIMD_AVX512:
+            return kernel_table_avx512();
+        case ATMOS_SIMD_AVX2:
+            return kernel_table_avx2();
+        case ATMOS_SIMD_SSE41:
+            return kernel_table_sse41();
+        default:
+            return kernel_table_sse2();
+    }
+}
+
+static const AtmosKernelTable* select_startup_kernel_table()
+{
+    uint32_t level = detect_cpu_simd_level();
+
+    const char* limit = getenv("ATMOS_SIMD_LEVEL");
+    if (limit && *limit >= '0' && *limit <= '9')
+    {
+        uint32_t requested = (uint32_t)atoi(limit);
+        if (requested < level)
+            level = requested;
+    }
+
+    return select_kernel_table(level);
+}
+
+static const AtmosKernelTable* s_kernelTable = select_startup_kernel_table();
+
+const AtmosKernelTable* atmos_kernel_table()
+{
+    if (!s_kernelTable)
+        s_kernelTable = select_startup_kernel_table();
+    return s_kernelTable;
+}
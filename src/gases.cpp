@@ -1,30 +1,15 @@
-#include "atmos_internal.h"
+#include "atmos_kernels.h"
+#include <stdlib.h>
 #include <string.h>
 
 float get_heat_capacity_impl(const float* moles, const float* specificHeats, bool space)
 {
-    float totalMoles = simd_horizontal_add(moles, ATMOS_GAS_COUNT);
-
-    if (space && totalMoles < 0.0001f)
-    {
-        return 7000.0f;
-    }
-
-    float heatCapacity = simd_dot_product(moles, specificHeats, ATMOS_GAS_ARRAY_SIZE);
-    return simd_max(heatCapacity, 0.0003f);
+    return atmos_kernel_table()->heatCapacity(moles, specificHeats, space);
 }
 
 float get_heat_capacity_archived_impl(const TileAtmosData* tile, const float* specificHeats)
 {
-    if (tile->flags & TILE_FLAG_SPACE)
-    {
-        float totalMoles = simd_horizontal_add(tile->molesArchived, ATMOS_GAS_COUNT);
-        if (totalMoles < 0.0001f)
-            return 7000.0f;
-    }
-
-    float heatCapacity = simd_dot_product(tile->molesArchived, specificHeats, ATMOS_GAS_ARRAY_SIZE);
-    return simd_max(heatCapacity, 0.0003f);
+    return atmos_kernel_table()->heatCapacityArchived(tile, specificHeats);
 }
 
 float get_thermal_energy_impl(const TileAtmosData* tile, const float* specificHeats)
@@ -39,31 +24,59 @@ void archive_tile(TileAtmosData* tile)
     tile->temperatureArchived = tile->temperature;
 }
 
-int compare_exchange(const TileAtmosData* a, const TileAtmosData* b, const AtmosConfig* config)
+void begin_archive_epoch(GridAtmosState* state)
 {
-    float totalMoles = 0.0f;
+    if (++state->archiveEpoch <= 0)
+    {
+        memset(state->archivedEpochs, 0, state->tileCapacity * sizeof(int32_t));
+        state->archiveEpoch = 1;
+    }
+}
 
-    for (int i = 0; i < ATMOS_GAS_COUNT; i++)
+void clear_unused_gases(const GridAtmosState* state, TileAtmosData* tile)
+{
+    for (int g = state->gasCount; g < ATMOS_GAS_ARRAY_SIZE; g++)
     {
-        float gasMoles = a->moles[i];
-        float delta = simd_abs(gasMoles - b->moles[i]);
+        tile->moles[g] = 0.0f;
+        tile->molesArchived[g] = 0.0f;
+    }
+}
 
-        if (delta > config->constants.minimumMolesDeltaToMove &&
-            delta > gasMoles * config->constants.minimumAirRatioToMove)
-        {
-            return i;
-        }
-        totalMoles += gasMoles;
+void archive_tile_epoch(GridAtmosState* state, int32_t tileIndex)
+{
+    if (state->archivedEpochs[tileIndex] == state->archiveEpoch)
+        return;
+
+    state->archivedEpochs[tileIndex] = state->archiveEpoch;
+
+    TileAtmosData* tile = &state->tiles[tileIndex];
+    if (!(tile->flags & TILE_FLAG_IMMUTABLE))
+    {
+        // Full-width sums and kernels read every slot, so drop anything the host wrote past gasCount.
+        clear_unused_gases(state, tile);
+        archive_tile(tile);
     }
+}
+
+void archive_tile_and_neighbors(GridAtmosState* state, int32_t tileIndex)
+{
+    archive_tile_epoch(state, tileIndex);
 
-    if (totalMoles > config->constants.minimumMolesDeltaToMove)
+    const TileAtmosData* tile = &state->tiles[tileIndex];
+    for (int i = 0; i < ATMOS_DIRECTIONS; i++)
     {
-        float tempDelta = simd_abs(a->temperature - b->temperature);
-        if (tempDelta > config->constants.minimumTemperatureDeltaToSuspend)
-            return -1;
+        if (!(tile->adjacentBits & (1 << i)))
+            continue;
+
+        int32_t adjIndex = tile->adjacentIndices[i];
+        if (adjIndex >= 0 && adjIndex < state->tileCount)
+            archive_tile_epoch(state, adjIndex);
     }
+}
 
-    return -2;
+int compare_exchange(const TileAtmosData* a, const TileAtmosData* b, const AtmosConfig* config)
+{
+    return compare_exchange_t<ATMOS_GAS_ARRAY_SIZE>(a, b, config);
 }
 
 void merge_impl(TileAtmosData* receiver, const float* giverMoles, float giverTemp,
@@ -130,7 +143,7 @@ void remove_ratio_impl(TileAtmosData* tile, float ratio, TileAtmosData* removed,
 
     if (!(tile->flags & TILE_FLAG_IMMUTABLE))
     {
-        for (int i = 0; i < ATMOS_GAS_COUNT; i++)
+        for (int i = 0; i < ATMOS_GAS_ARRAY_SIZE; i++)
         {
             tile->moles[i] -= tile->moles[i] * ratio;
             if (tile->moles[i] < gasMinMoles)
@@ -139,6 +152,42 @@ void remove_ratio_impl(TileAtmosData* tile, float ratio, TileAtmosData* removed,
     }
 }
 
+bool tile_set_contains(const int32_t* items, int32_t count, const int32_t* slots, int32_t tileIndex)
+{
+    int32_t slot = slots[tileIndex];
+    return slot >= 0 && slot < count && items[slot] == tileIndex;
+}
+
+void tile_set_insert(int32_t** items, int32_t* count, int32_t* capacity, int32_t* slots, int32_t tileIndex)
+{
+    if (tile_set_contains(*items, *count, slots, tileIndex))
+        return;
+
+    if (*count >= *capacity)
+    {
+        int32_t newCapacity = *capacity > 0 ? *capacity * 2 : 64;
+        *items = (int32_t*)realloc(*items, newCapacity * sizeof(int32_t));
+        *capacity = newCapacity;
+    }
+
+    slots[tileIndex] = *count;
+    (*items)[(*count)++] = tileIndex;
+}
+
+bool tile_set_remove(int32_t* items, int32_t* count, int32_t* slots, int32_t tileIndex)
+{
+    if (!tile_set_contains(items, *count, slots, tileIndex))
+        return false;
+
+    int32_t slot = slots[tileIndex];
+
+    int32_t last = items[--(*count)];
+    items[slot] = last;
+    slots[last] = slot;
+    slots[tileIndex] = -1;
+    return true;
+}
+
 void add_active_tile_impl(GridAtmosState* state, int32_t tileIndex)
 {
     if (!state || tileIndex < 0 || tileIndex >= state->tileCount)
@@ -149,10 +198,12 @@ void add_active_tile_impl(GridAtmosState* state, int32_t tileIndex)
     if (tile->flags & TILE_FLAG_EXCITED)
         return;
 
+    if (tile->excitedGroupId >= 0)
+        wake_excited_group(state, tile->excitedGroupId);
+
     tile->flags |= TILE_FLAG_EXCITED;
 
-    ensure_active_capacity(state, state->activeTileCount + 1);
-    state->activeTiles[state->activeTileCount++] = tileIndex;
+    tile_set_insert(&state->activeTiles, &state->activeTileCount, &state->activeTileCapacity, state->activeSlots, tileIndex);
 }
 
 void remove_active_tile_impl(GridAtmosState* state, int32_t tileIndex, bool disposeGroup)
@@ -167,14 +218,7 @@ void remove_active_tile_impl(GridAtmosState* state, int32_t tileIndex, bool disp
 
     tile->flags &= ~TILE_FLAG_EXCITED;
 
-    for (int i = 0; i < state->activeTileCount; i++)
-    {
-        if (state->activeTiles[i] == tileIndex)
-        {
-            state->activeTiles[i] = state->activeTiles[--state->activeTileCount];
-            break;
-        }
-    }
+    tile_set_remove(state->activeTiles, &state->activeTileCount, state->activeSlots, tileIndex);
 
     if (tile->excitedGroupId >= 0 && disposeGroup)
     {
@@ -188,227 +232,294 @@ void remove_active_tile_impl(GridAtmosState* state, int32_t tileIndex, bool disp
     tile->excitedGroupId = -1;
 }
 
-int32_t create_excited_group(GridAtmosState* state)
+static int32_t find_group_root(ExcitedGroupData* groups, int32_t groupId)
 {
-    ensure_excited_group_capacity(state, state->excitedGroupCount + 1);
-
-    for (int i = 0; i < state->excitedGroupCapacity; i++)
+    while (groups[groupId].parent != groupId)
     {
-        if (state->excitedGroups[i].disposed || state->excitedGroups[i].tileCount == 0)
-        {
-            ExcitedGroupData* group = &state->excitedGroups[i];
-            group->id = i;
-            group->breakdownCooldown = 0;
-            group->dismantleCooldown = 0;
-            group->tileCount = 0;
-            group->disposed = 0;
-
-            if (!group->tileIndices)
-            {
-                group->tileCapacity = 64;
-                group->tileIndices = (int32_t*)malloc(64 * sizeof(int32_t));
-            }
-
-            if (i >= state->excitedGroupCount)
-                state->excitedGroupCount = i + 1;
-
-            return i;
-        }
+        groups[groupId].parent = groups[groups[groupId].parent].parent;
+        groupId = groups[groupId].parent;
     }
-
-    return -1;
+    return groupId;
 }
 
-void add_tile_to_excited_group(GridAtmosState* state, int32_t groupId, int32_t tileIndex)
+int32_t resolve_excited_group(GridAtmosState* state, int32_t groupId)
 {
     if (groupId < 0 || groupId >= state->excitedGroupCount)
-        return;
+        return -1;
 
-    ExcitedGroupData* group = &state->excitedGroups[groupId];
-    if (group->disposed)
-        return;
+    if (state->excitedGroups[groupId].disposed)
+        return -1;
 
-    TileAtmosData* tile = &state->tiles[tileIndex];
-    tile->excitedGroupId = groupId;
+    return find_group_root(state->excitedGroups, groupId);
+}
+
+int32_t create_excited_group(GridAtmosState* state)
+{
+    int32_t groupId = state->freeExcitedGroup;
 
-    if (group->tileCount >= group->tileCapacity)
+    if (groupId >= 0)
     {
-        int32_t newCapacity = group->tileCapacity * 2;
-        group->tileIndices = (int32_t*)realloc(group->tileIndices, newCapacity * sizeof(int32_t));
-        group->tileCapacity = newCapacity;
+        state->freeExcitedGroup = state->excitedGroups[groupId].nextMember;
     }
+    else
+    {
+        ensure_excited_group_capacity(state, state->excitedGroupCount + 1);
+        groupId = state->excitedGroupCount++;
+    }
+
+    ExcitedGroupData* group = &state->excitedGroups[groupId];
+    group->id = groupId;
+    group->breakdownCooldown = 0;
+    group->dismantleCooldown = 0;
+    group->tileCount = 0;
+    group->parent = groupId;
+    group->firstTile = -1;
+    group->lastTile = -1;
+    group->nextMember = -1;
+    group->lastMember = groupId;
+    group->peakShare = 0.0f;
+    group->peakTemperatureDelta = 0.0f;
+    group->calmCycles = 0;
+    group->disposed = 0;
+    group->sleeping = 0;
+
+    return groupId;
+}
+
+static void link_group_tile(GridAtmosState* state, ExcitedGroupData* group, int32_t tileIndex)
+{
+    state->groupTilePrev[tileIndex] = group->lastTile;
+    state->groupTileNext[tileIndex] = -1;
 
-    group->tileIndices[group->tileCount++] = tileIndex;
+    if (group->lastTile >= 0)
+        state->groupTileNext[group->lastTile] = tileIndex;
+    else
+        group->firstTile = tileIndex;
+
+    group->lastTile = tileIndex;
+    group->tileCount++;
 }
 
-void remove_tile_from_excited_group(GridAtmosState* state, int32_t groupId, int32_t tileIndex)
+static void unlink_group_tile(GridAtmosState* state, ExcitedGroupData* group, int32_t tileIndex)
 {
-    if (groupId < 0 || groupId >= state->excitedGroupCount)
+    int32_t prev = state->groupTilePrev[tileIndex];
+    int32_t next = state->groupTileNext[tileIndex];
+
+    bool linked = prev >= 0 ? state->groupTileNext[prev] == tileIndex : group->firstTile == tileIndex;
+    if (!linked)
         return;
 
-    ExcitedGroupData* group = &state->excitedGroups[groupId];
-    if (group->disposed)
+    if (prev >= 0)
+        state->groupTileNext[prev] = next;
+    else
+        group->firstTile = next;
+
+    if (next >= 0)
+        state->groupTilePrev[next] = prev;
+    else
+        group->lastTile = prev;
+
+    state->groupTilePrev[tileIndex] = -1;
+    state->groupTileNext[tileIndex] = -1;
+    group->tileCount--;
+}
+
+void add_tile_to_excited_group(GridAtmosState* state, int32_t groupId, int32_t tileIndex)
+{
+    int32_t root = resolve_excited_group(state, groupId);
+    if (root < 0)
         return;
 
-    for (int i = 0; i < group->tileCount; i++)
-    {
-        if (group->tileIndices[i] == tileIndex)
-        {
-            group->tileIndices[i] = group->tileIndices[--group->tileCount];
-            break;
-        }
-    }
+    TileAtmosData* tile = &state->tiles[tileIndex];
+    if (tile->excitedGroupId >= 0)
+        remove_tile_from_excited_group(state, tile->excitedGroupId, tileIndex);
+
+    tile->excitedGroupId = root;
+    link_group_tile(state, &state->excitedGroups[root], tileIndex);
+}
+
+void remove_tile_from_excited_group(GridAtmosState* state, int32_t groupId, int32_t tileIndex)
+{
+    int32_t root = resolve_excited_group(state, groupId);
+    if (root < 0)
+        return;
 
+    unlink_group_tile(state, &state->excitedGroups[root], tileIndex);
     state->tiles[tileIndex].excitedGroupId = -1;
 }
 
 void merge_excited_groups(GridAtmosState* state, int32_t group1, int32_t group2)
 {
-    if (group1 == group2)
-        return;
+    int32_t root1 = resolve_excited_group(state, group1);
+    int32_t root2 = resolve_excited_group(state, group2);
 
-    if (group1 < 0 || group1 >= state->excitedGroupCount)
-        return;
-    if (group2 < 0 || group2 >= state->excitedGroupCount)
+    if (root1 < 0 || root2 < 0 || root1 == root2)
         return;
 
-    ExcitedGroupData* g1 = &state->excitedGroups[group1];
-    ExcitedGroupData* g2 = &state->excitedGroups[group2];
+    wake_excited_group(state, root1);
+    wake_excited_group(state, root2);
 
-    if (g1->disposed || g2->disposed)
-        return;
+    state->stats.groupMerges++;
+
+    ExcitedGroupData* g1 = &state->excitedGroups[root1];
+    ExcitedGroupData* g2 = &state->excitedGroups[root2];
 
-    int32_t neededCapacity = g1->tileCount + g2->tileCount;
-    if (neededCapacity > g1->tileCapacity)
+    if (g1->tileCount < g2->tileCount)
     {
-        int32_t newCapacity = g1->tileCapacity;
-        while (newCapacity < neededCapacity)
-            newCapacity *= 2;
-        g1->tileIndices = (int32_t*)realloc(g1->tileIndices, newCapacity * sizeof(int32_t));
-        g1->tileCapacity = newCapacity;
+        g2->breakdownCooldown = g1->breakdownCooldown;
+        g2->dismantleCooldown = g1->dismantleCooldown;
+
+        ExcitedGroupData* swap = g1;
+        g1 = g2;
+        g2 = swap;
     }
 
-    for (int i = 0; i < g2->tileCount; i++)
+    g2->parent = g1->id;
+
+    if (g2->firstTile >= 0)
     {
-        int32_t tileIdx = g2->tileIndices[i];
-        state->tiles[tileIdx].excitedGroupId = group1;
-        g1->tileIndices[g1->tileCount++] = tileIdx;
+        if (g1->lastTile >= 0)
+        {
+            state->groupTileNext[g1->lastTile] = g2->firstTile;
+            state->groupTilePrev[g2->firstTile] = g1->lastTile;
+        }
+        else
+        {
+            g1->firstTile = g2->firstTile;
+        }
+        g1->lastTile = g2->lastTile;
     }
 
+    g1->tileCount += g2->tileCount;
     g2->tileCount = 0;
-    g2->disposed = 1;
+    g2->firstTile = -1;
+    g2->lastTile = -1;
+
+    state->excitedGroups[g1->lastMember].nextMember = g2->id;
+    g1->lastMember = g2->lastMember;
 }
 
 void dispose_excited_group(GridAtmosState* state, int32_t groupId)
 {
-    if (groupId < 0 || groupId >= state->excitedGroupCount)
+    int32_t root = resolve_excited_group(state, groupId);
+    if (root < 0)
         return;
 
-    ExcitedGroupData* group = &state->excitedGroups[groupId];
-    if (group->disposed)
-        return;
+    ExcitedGroupData* group = &state->excitedGroups[root];
 
-    for (int i = 0; i < group->tileCount; i++)
+    for (int32_t tileIdx = group->firstTile; tileIdx >= 0;)
     {
-        int32_t tileIdx = group->tileIndices[i];
-        if (tileIdx >= 0 && tileIdx < state->tileCount)
+        int32_t next = state->groupTileNext[tileIdx];
+
+        if (tileIdx < state->tileCount)
             state->tiles[tileIdx].excitedGroupId = -1;
+        state->groupTilePrev[tileIdx] = -1;
+        state->groupTileNext[tileIdx] = -1;
+
+        tileIdx = next;
     }
 
-    group->tileCount = 0;
-    group->disposed = 1;
+    for (int32_t member = root; member >= 0;)
+    {
+        ExcitedGroupData* slot = &state->excitedGroups[member];
+        int32_t next = slot->nextMember;
+
+        slot->tileCount = 0;
+        slot->firstTile = -1;
+        slot->lastTile = -1;
+        slot->disposed = 1;
+        slot->nextMember = state->freeExcitedGroup;
+        state->freeExcitedGroup = member;
+
+        member = next;
+    }
 }
 
 void reset_excited_group_cooldowns(GridAtmosState* state, int32_t groupId)
 {
-    if (groupId < 0 || groupId >= state->excitedGroupCount)
+    int32_t root = resolve_excited_group(state, groupId);
+    if (root < 0)
         return;
 
-    ExcitedGroupData* group = &state->excitedGroups[groupId];
-    if (group->disposed)
-        return;
+    ExcitedGroupData* group = &state->excitedGroups[root];
 
     group->breakdownCooldown = 0;
     group->dismantleCooldown = 0;
 }
 
-void excited_group_self_breakdown(GridAtmosState* state, int32_t groupId, const AtmosConfig* config)
+void sleep_excited_group(GridAtmosState* state, int32_t groupId)
 {
-    if (groupId < 0 || groupId >= state->excitedGroupCount)
+    int32_t root = resolve_excited_group(state, groupId);
+    if (root < 0)
         return;
 
-    ExcitedGroupData* group = &state->excitedGroups[groupId];
-    if (group->disposed || group->tileCount == 0)
+    ExcitedGroupData* group = &state->excitedGroups[root];
+    if (group->sleeping)
         return;
 
-    float combinedHeatCapacity = 0.0f;
-    float combinedTemperature = 0.0f;
-    float combinedMoles[ATMOS_GAS_ARRAY_SIZE] = {0};
+    group->sleeping = 1;
+    state->stats.groupSleeps++;
 
-    for (int i = 0; i < group->tileCount; i++)
+    for (int32_t tileIdx = group->firstTile; tileIdx >= 0; tileIdx = state->groupTileNext[tileIdx])
     {
-        int32_t tileIdx = group->tileIndices[i];
         TileAtmosData* tile = &state->tiles[tileIdx];
-
-        if (tile->flags & TILE_FLAG_IMMUTABLE)
+        if (!(tile->flags & TILE_FLAG_EXCITED))
             continue;
 
-        float tileHC = get_heat_capacity_impl(tile->moles, config->gasSpecificHeats, (tile->flags & TILE_FLAG_SPACE) != 0);
-        combinedHeatCapacity += tileHC;
-        combinedTemperature += tile->temperature * tileHC;
-
-        for (int g = 0; g < ATMOS_GAS_COUNT; g++)
-            combinedMoles[g] += tile->moles[g];
+        tile->flags &= ~TILE_FLAG_EXCITED;
+        tile_set_remove(state->activeTiles, &state->activeTileCount, state->activeSlots, tileIdx);
     }
+}
 
-    if (combinedHeatCapacity > config->constants.minimumHeatCapacity)
-        combinedTemperature /= combinedHeatCapacity;
+void wake_excited_group(GridAtmosState* state, int32_t groupId)
+{
+    int32_t root = resolve_excited_group(state, groupId);
+    if (root < 0)
+        return;
 
-    int mutableTiles = 0;
-    for (int i = 0; i < group->tileCount; i++)
-    {
-        int32_t tileIdx = group->tileIndices[i];
-        TileAtmosData* tile = &state->tiles[tileIdx];
-        if (!(tile->flags & TILE_FLAG_IMMUTABLE))
-            mutableTiles++;
-    }
+    ExcitedGroupData* group = &state->excitedGroups[root];
+    if (!group->sleeping)
+        return;
 
-    if (mutableTiles > 0)
-    {
-        float divisor = 1.0f / mutableTiles;
-        for (int i = 0; i < group->tileCount; i++)
-        {
-            int32_t tileIdx = group->tileIndices[i];
-            TileAtmosData* tile = &state->tiles[tileIdx];
+    group->sleeping = 0;
+    group->calmCycles = 0;
+    state->stats.groupWakes++;
 
-            if (tile->flags & TILE_FLAG_IMMUTABLE)
-                continue;
+    for (int32_t tileIdx = group->firstTile; tileIdx >= 0; tileIdx = state->groupTileNext[tileIdx])
+        add_active_tile_impl(state, tileIdx);
+}
 
-            tile->temperature = combinedTemperature;
-            for (int g = 0; g < ATMOS_GAS_COUNT; g++)
-                tile->moles[g] = combinedMoles[g] * divisor;
-        }
-    }
+void excited_group_self_breakdown(GridAtmosState* state, int32_t groupId, const AtmosConfig* config)
+{
+    int32_t root = resolve_excited_group(state, groupId);
+    if (root < 0)
+        return;
+
+    ExcitedGroupData* group = &state->excitedGroups[root];
+    if (group->tileCount == 0)
+        return;
+
+    atmos_kernel_table()->groupBreakdown(state->tiles, state->groupTileNext, group->firstTile, state->gasCount, config);
 
     group->breakdownCooldown = 0;
 }
 
 void deactivate_group_tiles(GridAtmosState* state, int32_t groupId)
 {
-    if (groupId < 0 || groupId >= state->excitedGroupCount)
+    int32_t root = resolve_excited_group(state, groupId);
+    if (root < 0)
         return;
 
-    ExcitedGroupData* group = &state->excitedGroups[groupId];
-    if (group->disposed)
-        return;
+    ExcitedGroupData* group = &state->excitedGroups[root];
 
-    for (int i = 0; i < group->tileCount; i++)
+    for (int32_t tileIdx = group->firstTile; tileIdx >= 0;)
     {
-        int32_t tileIdx = group->tileIndices[i];
+        int32_t next = state->groupTileNext[tileIdx];
         remove_active_tile_impl(state, tileIdx, false);
+        tileIdx = next;
     }
 
-    dispose_excited_group(state, groupId);
+    dispose_excited_group(state, root);
 }
 
 void consider_pressure_difference(GridAtmosState* state, int32_t tileIndex, int direction, float pressureDiff)
@@ -423,26 +534,30 @@ void consider_pressure_difference(GridAtmosState* state, int32_t tileIndex, int
         tile->pressureDifference = simd_abs(pressureDiff);
         tile->currentTransferDirection = direction;
 
-        bool found = false;
-        for (int i = 0; i < state->highPressureTileCount; i++)
-        {
-            if (state->highPressureTiles[i] == tileIndex)
-            {
-                found = true;
-                break;
-            }
-        }
-
-        if (!found)
-        {
-            state->highPressureTiles[state->highPressureTileCount++] = tileIndex;
-        }
+        tile_set_insert(&state->highPressureTiles, &state->highPressureTileCount, &state->highPressureTileCapacity,
+                        state->highPressureSlots, tileIndex);
     }
 }
 
 void high_pressure_movements(GridAtmosState* state, int32_t tileIndex, const AtmosConfig* config)
 {
-    (void)state;
-    (void)tileIndex;
     (void)config;
+
+    const TileAtmosData* tile = &state->tiles[tileIndex];
+    if (tile->currentTransferDirection < 0 || tile->pressureDifference <= 0.0f)
+        return;
+
+    if (state->windEventCount >= state->windEventCapacity)
+    {
+        int32_t newCapacity = state->windEventCapacity > 0 ? state->windEventCapacity * 2 : 64;
+        state->windEvents = (AtmosWindEvent*)realloc(state->windEvents, newCapacity * sizeof(AtmosWindEvent));
+        state->windEventCapacity = newCapacity;
+    }
+
+    state->stats.windEvents++;
+
+    AtmosWindEvent* event = &state->windEvents[state->windEventCount++];
+    event->tileIndex = tileIndex;
+    event->direction = tile->currentTransferDirection;
+    event->pressureDifference = tile->pressureDifference;
 }
\ No newline at end of file
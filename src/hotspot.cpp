@@ -11,14 +11,7 @@ static void extinguish_hotspot_impl(GridAtmosState* state, int32_t tileIndex)
     tile->hotspotVolume = 0;
     tile->hotspotState = 0;
 
-    for (int i = 0; i < state->hotspotTileCount; i++)
-    {
-        if (state->hotspotTiles[i] == tileIndex)
-        {
-            state->hotspotTiles[i] = state->hotspotTiles[--state->hotspotTileCount];
-            break;
-        }
-    }
+    tile_set_remove(state->hotspotTiles, &state->hotspotTileCount, state->hotspotSlots, tileIndex);
 }
 
 void process_hotspot(GridAtmosState* state, int32_t tileIndex, const AtmosConfig* config)
@@ -129,19 +122,7 @@ void ignite_hotspot_impl(GridAtmosState* state, int32_t tileIndex, float tempera
     tile->flags |= TILE_FLAG_HOTSPOT;
     tile->hotspotState = 1;
 
-    bool found = false;
-    for (int i = 0; i < state->hotspotTileCount; i++)
-    {
-        if (state->hotspotTiles[i] == tileIndex)
-        {
-            found = true;
-            break;
-        }
-    }
-    if (!found)
-    {
-        state->hotspotTiles[state->hotspotTileCount++] = tileIndex;
-    }
+    tile_set_insert(&state->hotspotTiles, &state->hotspotTileCount, &state->hotspotTileCapacity, state->hotspotSlots, tileIndex);
 
     add_active_tile_impl(state, tileIndex);
 }
@@ -0,0 +1,3 @@
+#include "atmos_kernel_table.h"
+
+ATMOS_DEFINE_KERNEL_TABLE(kernel_table_sse41)
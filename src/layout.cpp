@@ -0,0 +1,200 @@
+#include "atmos_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+struct MortonEntry
+{
+    uint64_t code;
+    int32_t index;
+};
+
+static uint64_t spread_bits(uint32_t v)
+{
+    uint64_t x = v;
+    x = (x | (x << 16)) & 0x0000FFFF0000FFFFull;
+    x = (x | (x << 8))  & 0x00FF00FF00FF00FFull;
+    x = (x | (x << 4))  & 0x0F0F0F0F0F0F0F0Full;
+    x = (x | (x << 2))  & 0x3333333333333333ull;
+    x = (x | (x << 1))  & 0x5555555555555555ull;
+    return x;
+}
+
+static int morton_compare(const void* a, const void* b)
+{
+    const MortonEntry* ea = (const MortonEntry*)a;
+    const MortonEntry* eb = (const MortonEntry*)b;
+
+    if (ea->code != eb->code)
+        return ea->code < eb->code ? -1 : 1;
+    return ea->index - eb->index;
+}
+
+static int32_t remap_index(const int32_t* remap, int32_t index, int32_t count)
+{
+    return (index >= 0 && index < count) ? remap[index] : index;
+}
+
+static void permute_ints(int32_t* values, const int32_t* order, int32_t count, int32_t* scratch)
+{
+    for (int32_t i = 0; i < count; i++)
+        scratch[i] = values[order[i]];
+    memcpy(values, scratch, count * sizeof(int32_t));
+}
+
+static void remap_list(int32_t* list, int32_t length, const int32_t* remap, int32_t count)
+{
+    for (int32_t i = 0; i < length; i++)
+        list[i] = remap_index(remap, list[i], count);
+}
+
+bool optimize_tile_layout(GridAtmosState* state, int32_t* outRemap)
+{
+    int32_t count = state->tileCount;
+    if (count == 0)
+        return true;
+
+    MortonEntry* entries = (MortonEntry*)malloc(count * sizeof(MortonEntry));
+    int32_t* order = (int32_t*)malloc(count * sizeof(int32_t));
+    int32_t* remap = (int32_t*)malloc(count * sizeof(int32_t));
+    int32_t* scratch = (int32_t*)malloc(count * sizeof(int32_t));
+    TileAtmosData* tiles = (TileAtmosData*)malloc(count * sizeof(TileAtmosData));
+
+    if (!entries || !order || !remap || !scratch || !tiles)
+    {
+        free(entries);
+        free(order);
+        free(remap);
+        free(scratch);
+        free(tiles);
+        return false;
+    }
+
+    int32_t minX = state->tiles[0].gridX;
+    int32_t minY = state->tiles[0].gridY;
+    for (int32_t i = 1; i < count; i++)
+    {
+        if (state->tiles[i].gridX < minX) minX = state->tiles[i].gridX;
+        if (state->tiles[i].gridY < minY) minY = state->tiles[i].gridY;
+    }
+
+    for (int32_t i = 0; i < count; i++)
+    {
+        uint32_t x = (uint32_t)(state->tiles[i].gridX - minX);
+        uint32_t y = (uint32_t)(state->tiles[i].gridY - minY);
+        entries[i].code = spread_bits(x) | (spread_bits(y) << 1);
+        entries[i].index = i;
+    }
+
+    qsort(entries, count, sizeof(MortonEntry), morton_compare);
+
+    for (int32_t i = 0; i < count; i++)
+    {
+        order[i] = entries[i].index;
+        remap[entries[i].index] = i;
+    }
+
+    for (int32_t i = 0; i < count; i++)
+    {
+        tiles[i] = state->tiles[order[i]];
+        for (int d = 0; d < ATMOS_DIRECTIONS; d++)
+            tiles[i].adjacentIndices[d] = remap_index(remap, tiles[i].adjacentIndices[d], count);
+    }
+    memcpy(state->tiles, tiles, count * sizeof(TileAtmosData));
+
+    int32_t* perTile[7] = { state->activeSlots, state->hotspotSlots, state->superconductSlots, state->highPressureSlots,
+                            state->groupTileNext, state->groupTilePrev, state->archivedEpochs };
+    for (int i = 0; i < 7; i++)
+        permute_ints(perTile[i], order, count, scratch);
+
+    remap_list(state->groupTileNext, count, remap, count);
+    remap_list(state->groupTilePrev, count, remap, count);
+
+    remap_list(state->activeTiles, state->activeTileCount, remap, count);
+    remap_list(state->hotspotTiles, state->hotspotTileCount, remap, count);
+    remap_list(state->superconductTiles, state->superconductTileCount, remap, count);
+    remap_list(state->highPressureTiles, state->highPressureTileCount, remap, count);
+
+    for (int32_t i = 0; i < state->excitedGroupCount; i++)
+    {
+        ExcitedGroupData* group = &state->excitedGroups[i];
+        group->firstTile = remap_index(remap, group->firstTile, count);
+        group->lastTile = remap_index(remap, group->lastTile, count);
+    }
+
+    for (int32_t i = 0; i < state->windEventCount; i++)
+        state->windEvents[i].tileIndex = remap_index(remap, state->windEvents[i].tileIndex, count);
+
+    if (outRemap)
+        memcpy(outRemap, remap, count * sizeof(int32_t));
+
+    state->layoutGeneration++;
+
+    free(entries);
+    free(order);
+    free(remap);
+    free(scratch);
+    free(tiles);
+    return true;
+}
+
+bool reserve_tile_storage(GridAtmosState* state, int32_t maxTiles)
+{
+    size_t bytes = (size_t)maxTiles * sizeof(TileAtmosData);
+
+#ifdef _WIN32
+    void* base = VirtualAlloc(nullptr, bytes, MEM_RESERVE, PAGE_NOACCESS);
+    if (!base)
+        return false;
+
+    if (!VirtualAlloc(base, (size_t)state->tileCapacity * sizeof(TileAtmosData), MEM_COMMIT, PAGE_READWRITE))
+    {
+        VirtualFree(base, 0, MEM_RELEASE);
+        return false;
+    }
+#else
+    void* base = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (base == MAP_FAILED)
+        return false;
+#endif
+
+    memcpy(base, state->tiles, (size_t)state->tileCapacity * sizeof(TileAtmosData));
+    free(state->tiles);
+
+    state->tiles = (TileAtmosData*)base;
+    state->tileReservation = maxTiles;
+    state->layoutGeneration++;
+    return true;
+}
+
+bool commit_tile_storage(GridAtmosState* state, int32_t capacity)
+{
+#ifdef _WIN32
+    return VirtualAlloc(state->tiles, (size_t)capacity * sizeof(TileAtmosData), MEM_COMMIT, PAGE_READWRITE) != nullptr;
+#else
+    (void)state;
+    (void)capacity;
+    return true;
+#endif
+}
+
+void release_tile_storage(GridAtmosState* state)
+{
+    if (state->tileReservation == 0)
+    {
+        free(state->tiles);
+        return;
+    }
+
+#ifdef _WIN32
+    VirtualFree(state->tiles, 0, MEM_RELEASE);
+#else
+    munmap(state->tiles, (size_t)state->tileReservation * sizeof(TileAtmosData));
+#endif
+}
@@ -1,88 +1,13 @@
 #include "atmos_internal.h"
+#include <stdlib.h>
+#include <string.h>
 
 void share_impl(TileAtmosData* receiver, TileAtmosData* sharer, int adjacentCount, const AtmosConfig* config)
 {
     if (!receiver || !sharer || !config)
         return;
 
-    bool receiverImmutable = (receiver->flags & TILE_FLAG_IMMUTABLE) != 0;
-    bool sharerImmutable = (sharer->flags & TILE_FLAG_IMMUTABLE) != 0;
-
-    float temperatureDelta = receiver->temperatureArchived - sharer->temperatureArchived;
-    float absTemperatureDelta = simd_abs(temperatureDelta);
-
-    float oldHeatCapacity = 0.0f;
-    float oldSharerHeatCapacity = 0.0f;
-
-    if (absTemperatureDelta > config->constants.minimumTemperatureDeltaToConsider)
-    {
-        oldHeatCapacity = get_heat_capacity_impl(receiver->moles, config->gasSpecificHeats, (receiver->flags & TILE_FLAG_SPACE) != 0);
-        oldSharerHeatCapacity = get_heat_capacity_impl(sharer->moles, config->gasSpecificHeats, (sharer->flags & TILE_FLAG_SPACE) != 0);
-    }
-
-    float heatCapacityToSharer = 0.0f;
-    float heatCapacitySharerToThis = 0.0f;
-    float movedMoles = 0.0f;
-    float absMovedMoles = 0.0f;
-
-    float divisor = 1.0f / (adjacentCount + 1);
-
-    for (int i = 0; i < ATMOS_GAS_COUNT; i++)
-    {
-        float thisValue = receiver->moles[i];
-        float sharerValue = sharer->moles[i];
-        float delta = (thisValue - sharerValue) * divisor;
-
-        if (simd_abs(delta) < config->constants.gasMinMoles)
-            continue;
-
-        if (absTemperatureDelta > config->constants.minimumTemperatureDeltaToConsider)
-        {
-            float gasHeatCapacity = delta * config->gasSpecificHeats[i];
-            if (delta > 0)
-                heatCapacityToSharer += gasHeatCapacity;
-            else
-                heatCapacitySharerToThis -= gasHeatCapacity;
-        }
-
-        if (!receiverImmutable)
-            receiver->moles[i] -= delta;
-        if (!sharerImmutable)
-            sharer->moles[i] += delta;
-
-        movedMoles += delta;
-        absMovedMoles += simd_abs(delta);
-    }
-
-    receiver->lastShare = absMovedMoles;
-
-    if (absTemperatureDelta > config->constants.minimumTemperatureDeltaToConsider)
-    {
-        float newHeatCapacity = oldHeatCapacity + heatCapacitySharerToThis - heatCapacityToSharer;
-        float newSharerHeatCapacity = oldSharerHeatCapacity + heatCapacityToSharer - heatCapacitySharerToThis;
-
-        if (!receiverImmutable && newHeatCapacity > config->constants.minimumHeatCapacity)
-        {
-            receiver->temperature = ((oldHeatCapacity * receiver->temperature) -
-                                     (heatCapacityToSharer * receiver->temperatureArchived) +
-                                     (heatCapacitySharerToThis * sharer->temperatureArchived)) / newHeatCapacity;
-        }
-
-        if (!sharerImmutable && newSharerHeatCapacity > config->constants.minimumHeatCapacity)
-        {
-            sharer->temperature = ((oldSharerHeatCapacity * sharer->temperature) -
-                                   (heatCapacitySharerToThis * sharer->temperatureArchived) +
-                                   (heatCapacityToSharer * receiver->temperatureArchived)) / newSharerHeatCapacity;
-        }
-
-        if (simd_abs(oldSharerHeatCapacity) > config->constants.minimumHeatCapacity)
-        {
-            if (simd_abs(newSharerHeatCapacity / oldSharerHeatCapacity - 1.0f) < 0.1f)
-            {
-                temperature_share_impl(receiver, sharer, config->constants.openHeatTransferCoefficient, config);
-            }
-        }
-    }
+    atmos_kernel_table()->share(receiver, sharer, adjacentCount, config);
 }
 
 float temperature_share_impl(TileAtmosData* receiver, TileAtmosData* sharer, float conductionCoefficient, const AtmosConfig* config)
@@ -90,12 +15,19 @@ float temperature_share_impl(TileAtmosData* receiver, TileAtmosData* sharer, flo
     if (!receiver || !sharer || !config)
         return 0.0f;
 
-    float temperatureDelta = receiver->temperatureArchived - sharer->temperatureArchived;
+    return atmos_kernel_table()->temperatureShare(receiver, sharer, conductionCoefficient, config);
+}
+
+float temperature_share_solid(TileAtmosData* receiver, float conductionCoefficient, float sharerTemp, float sharerHeatCapacity, const AtmosConfig* config)
+{
+    if (!receiver || !config)
+        return sharerTemp;
+
+    float temperatureDelta = receiver->temperatureArchived - sharerTemp;
 
     if (simd_abs(temperatureDelta) > config->constants.minimumTemperatureDeltaToConsider)
     {
         float heatCapacity = get_heat_capacity_archived_impl(receiver, config->gasSpecificHeats);
-        float sharerHeatCapacity = get_heat_capacity_archived_impl(sharer, config->gasSpecificHeats);
 
         if (sharerHeatCapacity > config->constants.minimumHeatCapacity &&
             heatCapacity > config->constants.minimumHeatCapacity)
@@ -108,43 +40,83 @@ float temperature_share_impl(TileAtmosData* receiver, TileAtmosData* sharer, flo
                 receiver->temperature = simd_max(receiver->temperature - heat / heatCapacity, config->constants.TCMB);
             }
 
-            if (!(sharer->flags & TILE_FLAG_IMMUTABLE))
-            {
-                sharer->temperature = simd_max(sharer->temperature + heat / sharerHeatCapacity, config->constants.TCMB);
-            }
+            sharerTemp = simd_max(sharerTemp + heat / sharerHeatCapacity, config->constants.TCMB);
         }
     }
 
-    return sharer->temperature;
+    return sharerTemp;
 }
 
-float temperature_share_solid(TileAtmosData* receiver, float conductionCoefficient, float sharerTemp, float sharerHeatCapacity, const AtmosConfig* config)
+#define LINDA_COLOR_SERIAL    LINDA_COLOR_COUNT
+
+void apply_last_share(GridAtmosState* state, TileAtmosData* tile, float lastShare, float temperatureDelta, const AtmosConfig* config)
 {
-    if (!receiver || !config)
-        return sharerTemp;
+    int32_t groupId = resolve_excited_group(state, tile->excitedGroupId);
+    if (groupId < 0)
+        return;
 
-    float temperatureDelta = receiver->temperatureArchived - sharerTemp;
+    ExcitedGroupData* group = &state->excitedGroups[groupId];
+    group->peakShare = simd_max(group->peakShare, lastShare);
+    group->peakTemperatureDelta = simd_max(group->peakTemperatureDelta, temperatureDelta);
 
-    if (simd_abs(temperatureDelta) > config->constants.minimumTemperatureDeltaToConsider)
+    if (lastShare > config->constants.minimumAirToSuspend)
     {
-        float heatCapacity = get_heat_capacity_archived_impl(receiver, config->gasSpecificHeats);
+        group->breakdownCooldown = 0;
+        group->dismantleCooldown = 0;
+    }
+    else if (lastShare > config->constants.minimumMolesDeltaToMove)
+    {
+        group->dismantleCooldown = 0;
+    }
+}
 
-        if (sharerHeatCapacity > config->constants.minimumHeatCapacity &&
-            heatCapacity > config->constants.minimumHeatCapacity)
-        {
-            float heat = conductionCoefficient * temperatureDelta *
-                        (heatCapacity * sharerHeatCapacity / (heatCapacity + sharerHeatCapacity));
+void merge_cell_groups(GridAtmosState* state, int32_t tileIndex, int32_t adjIndex)
+{
+    int32_t group1 = state->tiles[tileIndex].excitedGroupId;
+    int32_t group2 = state->tiles[adjIndex].excitedGroupId;
 
-            if (!(receiver->flags & TILE_FLAG_IMMUTABLE))
-            {
-                receiver->temperature = simd_max(receiver->temperature - heat / heatCapacity, config->constants.TCMB);
-            }
+    if (group1 != group2)
+        merge_excited_groups(state, group1, group2);
+}
 
-            sharerTemp = simd_max(sharerTemp + heat / sharerHeatCapacity, config->constants.TCMB);
+void join_cell_groups(GridAtmosState* state, int32_t tileIndex, int32_t adjIndex)
+{
+    TileAtmosData* tile = &state->tiles[tileIndex];
+    TileAtmosData* enemyTile = &state->tiles[adjIndex];
+
+    int32_t groupId = tile->excitedGroupId;
+    if (groupId < 0)
+        groupId = enemyTile->excitedGroupId;
+    if (groupId < 0)
+    {
+        groupId = create_excited_group(state);
+    }
+
+    if (groupId >= 0)
+    {
+        if (tile->excitedGroupId < 0)
+            add_tile_to_excited_group(state, groupId, tileIndex);
+        if (enemyTile->excitedGroupId < 0)
+            add_tile_to_excited_group(state, groupId, adjIndex);
+    }
+}
+
+void finish_cell(GridAtmosState* state, int32_t tileIndex, float temperature, const AtmosConfig* config)
+{
+    TileAtmosData* tile = &state->tiles[tileIndex];
+
+    if (temperature > config->constants.minimumTemperatureStartSuperConduction)
+    {
+        if (consider_superconductivity(state, tileIndex, true, config))
+        {
+            return;
         }
     }
 
-    return sharerTemp;
+    if (config->excitedGroupsEnabled && tile->excitedGroupId < 0)
+    {
+        remove_active_tile_impl(state, tileIndex, true);
+    }
 }
 
 void process_cell(GridAtmosState* state, int32_t tileIndex, const AtmosConfig* config)
@@ -160,131 +132,270 @@ void process_cell(GridAtmosState* state, int32_t tileIndex, const AtmosConfig* c
         return;
     }
 
-    tile->lastCycle = state->updateCounter;
+    atmos_kernel_table()->processCell(state, tileIndex, config);
+}
 
-    int adjacentTileLength = 0;
-    for (int i = 0; i < ATMOS_DIRECTIONS; i++)
+void last_share_check(GridAtmosState* state, TileAtmosData* tile, const AtmosConfig* config)
+{
+    if (!state || !tile || !config)
+        return;
+
+    apply_last_share(state, tile, tile->lastShare, 0.0f, config);
+}
+
+static void replay_op_log(GridAtmosState* state, LindaOpLog* log, const AtmosConfig* config)
+{
+    for (int32_t i = 0; i < log->count; i++)
     {
-        if (tile->adjacentBits & (1 << i))
-            adjacentTileLength++;
+        const LindaCellOp* op = &log->ops[i];
+
+        switch (op->type)
+        {
+            case LINDA_OP_ACTIVATE:
+                add_active_tile_impl(state, op->tileIndex);
+                break;
+            case LINDA_OP_MERGE:
+                merge_cell_groups(state, op->tileIndex, op->otherIndex);
+                break;
+            case LINDA_OP_JOIN:
+                join_cell_groups(state, op->tileIndex, op->otherIndex);
+                break;
+            case LINDA_OP_PRESSURE:
+                consider_pressure_difference(state, op->tileIndex, op->direction, op->value);
+                break;
+            case LINDA_OP_LAST_SHARE:
+                apply_last_share(state, &state->tiles[op->tileIndex], op->value, op->auxValue, config);
+                break;
+            case LINDA_OP_REACTIONS:
+                record_reactions(state, (uint32_t)op->otherIndex);
+                break;
+            case LINDA_OP_FINISH:
+                finish_cell(state, op->tileIndex, op->value, config);
+                break;
+        }
     }
 
+    log->count = 0;
+}
+
+struct LindaBatchContext
+{
+    GridAtmosState* state;
+    const AtmosConfig* config;
+    const int32_t* tiles;
+    int32_t count;
+    LindaOpLog* logs;
+};
+
+static void process_cell_chunks(void* context, int32_t begin, int32_t end)
+{
+    LindaBatchContext* batch = (LindaBatchContext*)context;
+    const AtmosKernelTable* kernels = atmos_kernel_table();
+
+    for (int32_t chunk = begin; chunk < end; chunk++)
+    {
+        int32_t first = chunk * LINDA_BATCH_GRAIN;
+        int32_t count = batch->count - first < LINDA_BATCH_GRAIN ? batch->count - first : LINDA_BATCH_GRAIN;
+        kernels->processCellBatch(batch->state, batch->tiles + first, count, &batch->logs[chunk], batch->config);
+    }
+}
+
+static int tile_color(const GridAtmosState* state, const TileAtmosData* tile)
+{
     for (int i = 0; i < ATMOS_DIRECTIONS; i++)
     {
-        uint8_t dirBit = (1 << i);
-        if (!(tile->adjacentBits & dirBit))
+        if (!(tile->adjacentBits & (1 << i)))
             continue;
 
         int32_t adjIndex = tile->adjacentIndices[i];
         if (adjIndex < 0 || adjIndex >= state->tileCount)
             continue;
 
-        TileAtmosData* enemyTile = &state->tiles[adjIndex];
-        if (enemyTile->flags & TILE_FLAG_IMMUTABLE)
-            continue;
+        const TileAtmosData* adj = &state->tiles[adjIndex];
+        int32_t dx = adj->gridX - tile->gridX;
+        int32_t dy = adj->gridY - tile->gridY;
+        if ((dx < 0 ? -dx : dx) + (dy < 0 ? -dy : dy) != 1)
+            return LINDA_COLOR_SERIAL;
+    }
+
+    int color = (tile->gridX + 2 * tile->gridY) % LINDA_COLOR_COUNT;
+    return color < 0 ? color + LINDA_COLOR_COUNT : color;
+}
+
+static LindaPassScratch* ensure_linda_scratch(GridAtmosState* state, int32_t orderNeeded)
+{
+    LindaPassScratch* scratch = state->lindaScratch;
+    if (!scratch)
+    {
+        scratch = (LindaPassScratch*)calloc(1, sizeof(LindaPassScratch));
+        state->lindaScratch = scratch;
+    }
+
+    if (scratch->orderCapacity < orderNeeded)
+    {
+        int32_t newCapacity = scratch->orderCapacity > 0 ? scratch->orderCapacity : 64;
+        while (newCapacity < orderNeeded) newCapacity *= 2;
+
+        scratch->order = (int32_t*)realloc(scratch->order, 2 * newCapacity * sizeof(int32_t));
+        scratch->colors = (uint8_t*)realloc(scratch->colors, newCapacity);
+        scratch->orderCapacity = newCapacity;
+    }
 
-        if (state->updateCounter <= enemyTile->lastCycle)
+    return scratch;
+}
+
+static LindaOpLog* ensure_linda_logs(LindaPassScratch* scratch, int32_t needed)
+{
+    if (scratch->logCapacity < needed)
+    {
+        int32_t newCapacity = scratch->logCapacity > 0 ? scratch->logCapacity : 16;
+        while (newCapacity < needed) newCapacity *= 2;
+
+        scratch->logs = (LindaOpLog*)realloc(scratch->logs, newCapacity * sizeof(LindaOpLog));
+        memset(scratch->logs + scratch->logCapacity, 0, (newCapacity - scratch->logCapacity) * sizeof(LindaOpLog));
+        scratch->logCapacity = newCapacity;
+    }
+
+    return scratch->logs;
+}
+
+// Snapshots the active tiles and sorts them by colour. Immutable tiles join the serial
+// colour, where process_cell deactivates them.
+static void begin_linda_pass(GridAtmosState* state, LindaPassScratch* scratch)
+{
+    int32_t* snapshot = scratch->order + scratch->orderCapacity;
+    uint8_t* colors = scratch->colors;
+    int32_t snapshotCount = 0;
+    int32_t* colorStart = scratch->colorStart;
+
+    memset(colorStart, 0, sizeof(scratch->colorStart));
+
+    for (int i = 0; i < state->activeTileCount; i++)
+    {
+        int32_t tileIndex = state->activeTiles[i];
+        if (tileIndex < 0 || tileIndex >= state->tileCount)
             continue;
 
-        bool shouldShareAir = false;
+        TileAtmosData* tile = &state->tiles[tileIndex];
+        int color = (tile->flags & TILE_FLAG_IMMUTABLE) ? LINDA_COLOR_SERIAL : tile_color(state, tile);
+        snapshot[snapshotCount] = tileIndex;
+        colors[snapshotCount++] = (uint8_t)color;
+        colorStart[color + 1]++;
+    }
+
+    for (int c = 0; c <= LINDA_COLOR_COUNT; c++)
+        colorStart[c + 1] += colorStart[c];
 
-        if (config->excitedGroupsEnabled &&
-            tile->excitedGroupId >= 0 &&
-            enemyTile->excitedGroupId >= 0)
-        {
-            if (tile->excitedGroupId != enemyTile->excitedGroupId)
-            {
-                merge_excited_groups(state, tile->excitedGroupId, enemyTile->excitedGroupId);
-            }
-            shouldShareAir = true;
-        }
-        else
+    int32_t colorFill[LINDA_COLOR_COUNT + 1];
+    for (int c = 0; c <= LINDA_COLOR_COUNT; c++)
+        colorFill[c] = colorStart[c];
+
+    for (int i = 0; i < snapshotCount; i++)
+        scratch->order[colorFill[colors[i]]++] = snapshot[i];
+
+    scratch->cursor = 0;
+    scratch->monstermosCursor = 0;
+}
+
+// Parallel LINDA: runs the active tiles snapshotted at the start of the pass one colour at a
+// time, each colour after its Monstermos. Tiles of one colour share no neighbour, so a colour
+// gives the same result whether its cells run in order with direct effects or across the pool
+// with their effects logged and replayed in order afterwards; results do not depend on the
+// worker count. The archive phase has already archived every tile the pass touches; tiles
+// activated during the pass wait for the next tick. Monstermos and LINDA keep separate
+// cursors so a budgeted pass resumes inside either.
+int32_t process_active_tiles_batched(GridAtmosState* state, const AtmosConfig* config, AtmosBudget* budget, bool resume, bool* complete)
+{
+    bool parallel = thread_pool_get_size() > 1;
+
+    LindaPassScratch* scratch = ensure_linda_scratch(state, resume ? 0 : state->activeTileCount);
+    int32_t processed = 0;
+
+    if (!resume)
+        begin_linda_pass(state, scratch);
+
+    const int32_t* sorted = scratch->order;
+    const int32_t* colorStart = scratch->colorStart;
+    *complete = true;
+
+    for (int c = 0; c <= LINDA_COLOR_SERIAL; c++)
+    {
+        int32_t begin = scratch->cursor > colorStart[c] ? scratch->cursor : colorStart[c];
+        int32_t end = colorStart[c + 1];
+        if (begin >= end)
+            continue;
+
+        if (config->monstermosEnabled)
         {
-            int exchangeResult = compare_exchange(tile, enemyTile, config);
-            if (exchangeResult != -2)
+            int32_t first = scratch->monstermosCursor > colorStart[c] ? scratch->monstermosCursor : colorStart[c];
+            for (int32_t i = first; i < end; i++)
             {
-                add_active_tile_impl(state, adjIndex);
+                equalize_pressure_in_zone(state, sorted[i], config);
+                scratch->monstermosCursor = i + 1;
 
-                if (config->excitedGroupsEnabled)
+                if (budget_expired(budget))
                 {
-                    int32_t groupId = tile->excitedGroupId;
-                    if (groupId < 0)
-                        groupId = enemyTile->excitedGroupId;
-                    if (groupId < 0)
-                    {
-                        groupId = create_excited_group(state);
-                    }
-
-                    if (groupId >= 0)
-                    {
-                        if (tile->excitedGroupId < 0)
-                            add_tile_to_excited_group(state, groupId, tileIndex);
-                        if (enemyTile->excitedGroupId < 0)
-                            add_tile_to_excited_group(state, groupId, adjIndex);
-                    }
+                    *complete = false;
+                    return processed;
                 }
-
-                shouldShareAir = true;
             }
         }
 
-        if (shouldShareAir)
+        if (!parallel || c == LINDA_COLOR_SERIAL || begin != colorStart[c] || end - begin <= LINDA_BATCH_GRAIN)
         {
-            share_impl(tile, enemyTile, adjacentTileLength, config);
-
-            if (!config->monstermosEnabled)
+            for (int32_t i = begin; i < end; i++)
             {
-                float pressure1 = tile_pressure(tile, config->constants.R, config->constants.cellVolume);
-                float pressure2 = tile_pressure(enemyTile, config->constants.R, config->constants.cellVolume);
-                float difference = pressure1 - pressure2;
+                process_cell(state, sorted[i], config);
+                processed++;
+                scratch->cursor = i + 1;
 
-                if (difference >= 0)
-                {
-                    consider_pressure_difference(state, tileIndex, i, difference);
-                }
-                else
+                if (budget_expired(budget))
                 {
-                    consider_pressure_difference(state, adjIndex, opposite_dir(i), -difference);
+                    *complete = false;
+                    return processed;
                 }
             }
-
-            last_share_check(state, tile, config);
+            continue;
         }
-    }
 
-    react_impl(tile, config);
+        int32_t chunkCount = (end - begin + LINDA_BATCH_GRAIN - 1) / LINDA_BATCH_GRAIN;
 
-    if (tile->temperature > config->constants.minimumTemperatureStartSuperConduction)
-    {
-        if (consider_superconductivity(state, tileIndex, true, config))
+        LindaBatchContext batch;
+        batch.state = state;
+        batch.config = config;
+        batch.tiles = sorted + begin;
+        batch.count = end - begin;
+        batch.logs = ensure_linda_logs(scratch, chunkCount);
+
+        thread_pool_parallel_for(chunkCount, 1, process_cell_chunks, &batch);
+
+        for (int32_t i = 0; i < chunkCount; i++)
+            replay_op_log(state, &batch.logs[i], config);
+
+        processed += end - begin;
+        scratch->cursor = end;
+
+        if (budget_expired_now(budget))
         {
-            return;
+            *complete = false;
+            return processed;
         }
     }
 
-    if (config->excitedGroupsEnabled && tile->excitedGroupId < 0)
-    {
-        remove_active_tile_impl(state, tileIndex, true);
-    }
+    return processed;
 }
 
-void last_share_check(GridAtmosState* state, TileAtmosData* tile, const AtmosConfig* config)
+void free_linda_scratch(GridAtmosState* state)
 {
-    if (!state || !tile || !config)
-        return;
-
-    if (tile->excitedGroupId < 0)
+    LindaPassScratch* scratch = state->lindaScratch;
+    if (!scratch)
         return;
 
-    if (tile->lastShare > config->constants.minimumAirToSuspend)
-    {
-        reset_excited_group_cooldowns(state, tile->excitedGroupId);
-    }
-    else if (tile->lastShare > config->constants.minimumMolesDeltaToMove)
-    {
-        if (tile->excitedGroupId >= 0 && tile->excitedGroupId < state->excitedGroupCount)
-        {
-            state->excitedGroups[tile->excitedGroupId].dismantleCooldown = 0;
-        }
-    }
-}
\ No newline at end of file
+    free(scratch->order);
+    free(scratch->colors);
+    for (int32_t i = 0; i < scratch->logCapacity; i++)
+        free(scratch->logs[i].ops);
+    free(scratch->logs);
+    free(scratch);
+    state->lindaScratch = nullptr;
+}
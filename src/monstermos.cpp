@@ -1,25 +1,392 @@
 #include "atmos_internal.h"
 #include <stdlib.h>
+#include <string.h>
 #include <algorithm>
 
 static void finalize_eq_neighbors(GridAtmosState* state, int32_t tileIndex, const float* transferDirs, const AtmosConfig* config);
 
-static TileAtmosData* s_equalizeTiles[2000];
-static TileAtmosData* s_equalizeGiverTiles[2000];
-static TileAtmosData* s_equalizeTakerTiles[2000];
-static TileAtmosData* s_equalizeQueue[2000];
-static TileAtmosData* s_depressurizeTiles[2000];
-static TileAtmosData* s_depressurizeSpaceTiles[2000];
-static TileAtmosData* s_depressurizeProgressionOrder[4000];
+MonstermosScratch* ensure_monstermos_scratch(GridAtmosState* state, const AtmosConfig* config)
+{
+    MonstermosScratch* scratch = state->monstermosScratch;
+    if (!scratch)
+    {
+        scratch = (MonstermosScratch*)calloc(1, sizeof(MonstermosScratch));
+        state->monstermosScratch = scratch;
+    }
+
+    int32_t zoneCapacity = config->constants.monstermosHardTileLimit;
+    if (zoneCapacity < 1)
+        zoneCapacity = 1;
+
+    int32_t walkCapacity = zoneCapacity;
+    if (config->monstermosCoarseEnabled && config->constants.monstermosCoarseTileLimit > walkCapacity)
+        walkCapacity = config->constants.monstermosCoarseTileLimit;
+
+    if (scratch->walkCapacity < walkCapacity)
+    {
+        scratch->equalizeTiles = (TileAtmosData**)realloc(scratch->equalizeTiles, walkCapacity * sizeof(TileAtmosData*));
+        scratch->walkCapacity = walkCapacity;
+    }
+
+    if (scratch->zoneCapacity >= zoneCapacity)
+        return scratch;
+
+    int32_t queueCapacity = zoneCapacity * ATMOS_DIRECTIONS + ATMOS_DIRECTIONS + 1;
+    size_t zoneBytes = zoneCapacity * sizeof(TileAtmosData*);
+    size_t queueBytes = queueCapacity * sizeof(TileAtmosData*);
+
+    scratch->giverTiles = (TileAtmosData**)realloc(scratch->giverTiles, zoneBytes);
+    scratch->takerTiles = (TileAtmosData**)realloc(scratch->takerTiles, zoneBytes);
+    scratch->queue = (TileAtmosData**)realloc(scratch->queue, queueBytes);
+    scratch->depressurizeTiles = (TileAtmosData**)realloc(scratch->depressurizeTiles, zoneBytes);
+    scratch->spaceTiles = (TileAtmosData**)realloc(scratch->spaceTiles, zoneBytes);
+    scratch->progressionOrder = (TileAtmosData**)realloc(scratch->progressionOrder, queueBytes);
+    scratch->sortTiles = (TileAtmosData**)realloc(scratch->sortTiles, zoneBytes);
+    scratch->flowRoots = (int32_t*)realloc(scratch->flowRoots, queueCapacity * sizeof(int32_t));
+    scratch->sortKeys = (uint64_t*)realloc(scratch->sortKeys, zoneCapacity * sizeof(uint64_t));
+    scratch->sortScratch = (uint64_t*)realloc(scratch->sortScratch, zoneCapacity * sizeof(uint64_t));
+
+    scratch->zoneCapacity = zoneCapacity;
+    scratch->queueCapacity = queueCapacity;
+    return scratch;
+}
+
+static void free_zone_cache(ZoneRecordCache* cache)
+{
+    free(cache->zones);
+    free(cache->members);
+    free(cache->zoneOfTile);
+}
+
+void free_monstermos_scratch(GridAtmosState* state)
+{
+    MonstermosScratch* scratch = state->monstermosScratch;
+    if (!scratch)
+        return;
+
+    free(scratch->equalizeTiles);
+    free(scratch->giverTiles);
+    free(scratch->takerTiles);
+    free(scratch->queue);
+    free(scratch->depressurizeTiles);
+    free(scratch->spaceTiles);
+    free(scratch->progressionOrder);
+    free(scratch->sortTiles);
+    free(scratch->flowRoots);
+    free(scratch->sortKeys);
+    free(scratch->sortScratch);
+    free_zone_cache(&scratch->equalizeZones);
+    free_zone_cache(&scratch->depressurizeZones);
+    free(scratch->coarseTiles);
+    free(scratch->coarseBlocks);
+    free(scratch);
+    state->monstermosScratch = nullptr;
+}
+
+static void clear_zone_cache(ZoneRecordCache* cache)
+{
+    if (cache->zoneCount > 0)
+        memset(cache->zoneOfTile, 0xFF, cache->tileCapacity * sizeof(int32_t));
+
+    cache->zoneCount = 0;
+    cache->memberCount = 0;
+}
+
+static uint64_t zone_signature(const GridAtmosState* state, const int32_t* tiles, int32_t count)
+{
+    uint64_t hash = 14695981039346656037ull;
+
+    for (int32_t i = 0; i < count; i++)
+    {
+        if (tiles[i] >= state->tileCount)
+            return 0;
+
+        const TileAtmosData* tile = &state->tiles[tiles[i]];
+        hash = (hash ^ (uint32_t)(tile->adjacentBits | ((tile->flags & TILE_FLAG_SPACE) << 8))) * 1099511628211ull;
+        for (int d = 0; d < ATMOS_DIRECTIONS; d++)
+            hash = (hash ^ (uint32_t)tile->adjacentIndices[d]) * 1099511628211ull;
+    }
+
+    return hash;
+}
+
+static MonstermosZone* find_cached_zone(GridAtmosState* state, ZoneRecordCache* cache, int32_t startTileIndex, const AtmosConfig* config)
+{
+    MonstermosScratch* scratch = state->monstermosScratch;
+    if (scratch->zoneTopologyGeneration != state->topologyGeneration ||
+        scratch->zoneLayoutGeneration != state->layoutGeneration ||
+        scratch->zoneTileLimit != config->constants.monstermosTileLimit ||
+        scratch->zoneHardLimit != config->constants.monstermosHardTileLimit)
+    {
+        clear_zone_cache(&scratch->equalizeZones);
+        clear_zone_cache(&scratch->depressurizeZones);
+        scratch->zoneTopologyGeneration = state->topologyGeneration;
+        scratch->zoneLayoutGeneration = state->layoutGeneration;
+        scratch->zoneTileLimit = config->constants.monstermosTileLimit;
+        scratch->zoneHardLimit = config->constants.monstermosHardTileLimit;
+        return nullptr;
+    }
+
+    if (startTileIndex >= cache->tileCapacity || cache->zoneOfTile[startTileIndex] < 0)
+        return nullptr;
+
+    // Tiles written through atmos_get_tiles_ptr never bump the topology generation, so
+    // check the recorded tiles' adjacency before trusting the walk.
+    MonstermosZone* zone = &cache->zones[cache->zoneOfTile[startTileIndex]];
+    if (zone_signature(state, cache->members + zone->firstMember, zone->checkedCount) != zone->signature)
+    {
+        clear_zone_cache(&scratch->equalizeZones);
+        clear_zone_cache(&scratch->depressurizeZones);
+        return nullptr;
+    }
+
+    return zone;
+}
+
+static int32_t* begin_zone_record(GridAtmosState* state, ZoneRecordCache* cache, int32_t reserve)
+{
+    if (cache->tileCapacity < state->tileCount)
+    {
+        cache->zoneOfTile = (int32_t*)realloc(cache->zoneOfTile, state->tileCapacity * sizeof(int32_t));
+        memset(cache->zoneOfTile + cache->tileCapacity, 0xFF, (state->tileCapacity - cache->tileCapacity) * sizeof(int32_t));
+        cache->tileCapacity = state->tileCapacity;
+    }
+
+    int32_t budget = state->tileCount * 2 + reserve;
+    if (cache->memberCount + reserve > budget)
+        clear_zone_cache(cache);
+
+    if (cache->memberCount + reserve > cache->memberCapacity)
+    {
+        int32_t newCapacity = cache->memberCount + reserve;
+        if (newCapacity < budget)
+            newCapacity = budget;
+
+        cache->members = (int32_t*)realloc(cache->members, newCapacity * sizeof(int32_t));
+        cache->memberCapacity = newCapacity;
+    }
+
+    if (cache->zoneCount >= cache->zoneCapacity)
+    {
+        int32_t newCapacity = cache->zoneCapacity ? cache->zoneCapacity * 2 : 64;
+        cache->zones = (MonstermosZone*)realloc(cache->zones, newCapacity * sizeof(MonstermosZone));
+        cache->zoneCapacity = newCapacity;
+    }
+
+    return cache->members + cache->memberCount;
+}
+
+static void commit_zone_record(GridAtmosState* state, ZoneRecordCache* cache, int32_t startTileIndex, const MonstermosZone* record, int32_t length)
+{
+    MonstermosZone* zone = &cache->zones[cache->zoneCount];
+    *zone = *record;
+    zone->startTile = startTileIndex;
+    zone->firstMember = cache->memberCount;
+    zone->signature = zone_signature(state, cache->members + zone->firstMember, zone->checkedCount);
+
+    cache->zoneOfTile[startTileIndex] = cache->zoneCount++;
+    cache->memberCount += length;
+}
+
+static uint32_t sortable_float_bits(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
+void sort_tiles_by_mole_delta(TileAtmosData** tiles, int32_t count, MonstermosScratch* scratch)
+{
+    if (count < 2)
+        return;
+
+    uint64_t* keys = scratch->sortKeys;
+    uint64_t* temp = scratch->sortScratch;
+    uint32_t histograms[4][256] = {};
+
+    for (int32_t i = 0; i < count; i++)
+    {
+        uint32_t key = sortable_float_bits(tiles[i]->moleDelta);
+        keys[i] = ((uint64_t)key << 32) | (uint32_t)i;
+
+        histograms[0][key & 0xFF]++;
+        histograms[1][(key >> 8) & 0xFF]++;
+        histograms[2][(key >> 16) & 0xFF]++;
+        histograms[3][key >> 24]++;
+    }
+
+    for (int pass = 0; pass < 4; pass++)
+    {
+        uint32_t* histogram = histograms[pass];
+        int shift = 32 + pass * 8;
+
+        if (histogram[(keys[0] >> shift) & 0xFF] == (uint32_t)count)
+            continue;
+
+        uint32_t offset = 0;
+        for (int b = 0; b < 256; b++)
+        {
+            uint32_t bucket = histogram[b];
+            histogram[b] = offset;
+            offset += bucket;
+        }
+
+        for (int32_t i = 0; i < count; i++)
+            temp[histogram[(keys[i] >> shift) & 0xFF]++] = keys[i];
+
+        uint64_t* swap = keys;
+        keys = temp;
+        temp = swap;
+    }
+
+    for (int32_t i = 0; i < count; i++)
+        scratch->sortTiles[i] = tiles[(uint32_t)keys[i]];
+
+    memcpy(tiles, scratch->sortTiles, count * sizeof(TileAtmosData*));
+}
+
+static void settle_nearest_sources(GridAtmosState* state, MonstermosScratch* scratch, TileAtmosData** sources, int sourceCount,
+                                   float sign, int64_t queueCycle)
+{
+    TileAtmosData** queue = scratch->queue;
+    int32_t* roots = scratch->flowRoots;
+
+    int64_t queueCycleSlow = ++state->equalizationQueueCycle;
+    int queueLength = 0;
+
+    for (int i = 0; i < sourceCount; i++)
+    {
+        TileAtmosData* source = sources[i];
+        source->currentTransferDirection = -1;
+        source->currentTransferAmount = 0;
+        source->lastSlowQueueCycle = queueCycleSlow;
+        roots[queueLength] = queueLength;
+        queue[queueLength++] = source;
+    }
 
-static int tile_mole_delta_compare(const void* a, const void* b)
+    for (int i = 0; i < queueLength; i++)
+    {
+        TileAtmosData* otherTile = queue[i];
+        TileAtmosData* root = queue[roots[i]];
+
+        for (int k = 0; k < ATMOS_DIRECTIONS; k++)
+        {
+            if (!(otherTile->adjacentBits & (1 << k)))
+                continue;
+
+            int32_t adjIdx = otherTile->adjacentIndices[k];
+            if (adjIdx < 0 || adjIdx >= state->tileCount)
+                continue;
+
+            TileAtmosData* otherTile2 = &state->tiles[adjIdx];
+            if (sign < 0 && otherTile2->adjacentBits == 0)
+                continue;
+            if (otherTile2->lastQueueCycle != queueCycle)
+                continue;
+            if (otherTile2->lastSlowQueueCycle == queueCycleSlow)
+                continue;
+
+            roots[queueLength] = roots[i];
+            queue[queueLength++] = otherTile2;
+            otherTile2->lastSlowQueueCycle = queueCycleSlow;
+            otherTile2->currentTransferDirection = opposite_dir(k);
+            otherTile2->currentTransferAmount = 0;
+
+            float capacity = -sign * otherTile2->moleDelta;
+            float supply = sign * root->moleDelta;
+            if (capacity <= 0 || supply <= 0)
+                continue;
+
+            float amount = capacity < supply ? capacity : supply;
+            otherTile2->moleDelta += sign * amount;
+            root->moleDelta -= sign * amount;
+            otherTile2->currentTransferAmount -= sign * amount;
+        }
+    }
+
+    for (int i = queueLength - 1; i >= 0; i--)
+    {
+        TileAtmosData* otherTile = queue[i];
+        if (otherTile->currentTransferAmount == 0 || otherTile->currentTransferDirection < 0)
+            continue;
+
+        int dir = otherTile->currentTransferDirection;
+        int32_t adjIdx = otherTile->adjacentIndices[dir];
+        if (adjIdx < 0 || adjIdx >= state->tileCount)
+            continue;
+
+        TileAtmosData* adj = &state->tiles[adjIdx];
+        adjust_eq_movement(otherTile, adj, dir, otherTile->currentTransferAmount);
+        adj->currentTransferAmount += otherTile->currentTransferAmount;
+        otherTile->currentTransferAmount = 0;
+    }
+}
+
+// Sources whose nearest tiles were claimed by an exhausted neighbour can be left with
+// surplus. One spanning tree over the zone carries whatever is left in a single sweep.
+static void settle_residual_flow(GridAtmosState* state, MonstermosScratch* scratch, TileAtmosData** sources, int sourceCount,
+                                 float sign, int64_t queueCycle)
 {
-    TileAtmosData* ta = *(TileAtmosData**)a;
-    TileAtmosData* tb = *(TileAtmosData**)b;
+    TileAtmosData* root = nullptr;
+    for (int i = 0; i < sourceCount && !root; i++)
+    {
+        if (sign * sources[i]->moleDelta > 0)
+            root = sources[i];
+    }
+
+    if (!root)
+        return;
+
+    TileAtmosData** queue = scratch->queue;
+    int32_t* parents = scratch->flowRoots;
+
+    int64_t queueCycleSlow = ++state->equalizationQueueCycle;
+    int queueLength = 0;
+
+    root->lastSlowQueueCycle = queueCycleSlow;
+    parents[queueLength] = -1;
+    queue[queueLength++] = root;
+
+    for (int i = 0; i < queueLength; i++)
+    {
+        TileAtmosData* otherTile = queue[i];
+
+        for (int k = 0; k < ATMOS_DIRECTIONS; k++)
+        {
+            if (!(otherTile->adjacentBits & (1 << k)))
+                continue;
+
+            int32_t adjIdx = otherTile->adjacentIndices[k];
+            if (adjIdx < 0 || adjIdx >= state->tileCount)
+                continue;
+
+            TileAtmosData* otherTile2 = &state->tiles[adjIdx];
+            if (otherTile2->adjacentBits == 0)
+                continue;
+            if (otherTile2->lastQueueCycle != queueCycle)
+                continue;
+            if (otherTile2->lastSlowQueueCycle == queueCycleSlow)
+                continue;
+
+            otherTile2->lastSlowQueueCycle = queueCycleSlow;
+            otherTile2->currentTransferDirection = opposite_dir(k);
+            parents[queueLength] = i;
+            queue[queueLength++] = otherTile2;
+        }
+    }
 
-    if (ta->moleDelta < tb->moleDelta) return -1;
-    if (ta->moleDelta > tb->moleDelta) return 1;
-    return 0;
+    for (int i = queueLength - 1; i > 0; i--)
+    {
+        TileAtmosData* otherTile = queue[i];
+        float amount = otherTile->moleDelta;
+        if (amount == 0)
+            continue;
+
+        TileAtmosData* parent = queue[parents[i]];
+        adjust_eq_movement(otherTile, parent, otherTile->currentTransferDirection, amount);
+        parent->moleDelta += amount;
+        otherTile->moleDelta = 0;
+    }
 }
 
 void equalize_pressure_in_zone(GridAtmosState* state, int32_t startTileIndex, const AtmosConfig* config)
@@ -65,93 +432,184 @@ void equalize_pressure_in_zone(GridAtmosState* state, int32_t startTileIndex, co
         return;
     }
 
+    MonstermosScratch* scratch = ensure_monstermos_scratch(state, config);
+    TileAtmosData** equalizeTiles = scratch->equalizeTiles;
+    TileAtmosData** giverTiles = scratch->giverTiles;
+    TileAtmosData** takerTiles = scratch->takerTiles;
+
     int64_t queueCycle = ++state->equalizationQueueCycle;
     float totalMoles = 0.0f;
 
-    s_equalizeTiles[0] = startTile;
     startTile->lastQueueCycle = queueCycle;
     int tileCount = 1;
 
-    for (int i = 0; i < tileCount; i++)
+    ZoneRecordCache* zones = &scratch->equalizeZones;
+    MonstermosZone* zone = find_cached_zone(state, zones, startTileIndex, config);
+    if (zone && (zone->memberCount <= config->constants.monstermosTileLimit || config->monstermosCoarseEnabled))
     {
-        if (i > config->constants.monstermosHardTileLimit)
-            break;
-
-        TileAtmosData* exploring = s_equalizeTiles[i];
+        const int32_t* members = zones->members + zone->firstMember;
 
-        if (i < config->constants.monstermosTileLimit)
+        tileCount = zone->memberCount;
+        for (int i = 0; i < tileCount; i++)
         {
-            float tileMoles = tile_total_moles(exploring);
-            exploring->moleDelta = tileMoles;
-            totalMoles += tileMoles;
+            TileAtmosData* member = &state->tiles[members[i]];
+            member->moleDelta = 0;
+            member->fastDone = 0;
+            for (int k = 0; k < ATMOS_DIRECTIONS; k++)
+                member->transferDirections[k] = 0;
+            member->lastQueueCycle = queueCycle;
+            equalizeTiles[i] = member;
+
+            if (i < config->constants.monstermosTileLimit)
+            {
+                float tileMoles = tile_total_moles(member);
+                member->moleDelta = tileMoles;
+                totalMoles += tileMoles;
+            }
         }
 
-        for (int j = 0; j < ATMOS_DIRECTIONS; j++)
+        state->stats.monstermosZoneCacheHits++;
+    }
+    else
+    {
+        // A known zone past the tile limit only equalizes the tiles nearest the start, so
+        // the walk can stop there instead of covering the whole zone again. The coarse
+        // equalizer takes the whole zone, so with it enabled the walk goes on to its limit.
+        int32_t walkLimit = config->constants.monstermosHardTileLimit;
+        if (zone)
+            walkLimit = config->constants.monstermosTileLimit;
+        else if (config->monstermosCoarseEnabled && config->constants.monstermosCoarseTileLimit > walkLimit)
+            walkLimit = config->constants.monstermosCoarseTileLimit;
+        bool complete = true;
+
+        equalizeTiles[0] = startTile;
+
+        for (int i = 0; i < tileCount; i++)
         {
-            if (!(exploring->adjacentBits & (1 << j)))
-                continue;
+            if (i > walkLimit)
+                break;
 
-            int32_t adjIdx = exploring->adjacentIndices[j];
-            if (adjIdx < 0 || adjIdx >= state->tileCount)
-                continue;
+            TileAtmosData* exploring = equalizeTiles[i];
+            int32_t exploringIdx = (int32_t)(exploring - state->tiles);
 
-            TileAtmosData* adj = &state->tiles[adjIdx];
-            if (adj->lastQueueCycle == queueCycle)
-                continue;
+            if (i < config->constants.monstermosTileLimit)
+            {
+                float tileMoles = tile_total_moles(exploring);
+                exploring->moleDelta = tileMoles;
+                totalMoles += tileMoles;
+            }
 
-            adj->moleDelta = 0;
-            adj->fastDone = 0;
-            for (int k = 0; k < ATMOS_DIRECTIONS; k++)
-                adj->transferDirections[k] = 0;
-            adj->lastQueueCycle = queueCycle;
+            for (int j = 0; j < ATMOS_DIRECTIONS; j++)
+            {
+                if (!(exploring->adjacentBits & (1 << j)))
+                    continue;
 
-            if (tileCount < config->constants.monstermosHardTileLimit)
-                s_equalizeTiles[tileCount++] = adj;
+                int32_t adjIdx = exploring->adjacentIndices[j];
+                if (adjIdx < 0 || adjIdx >= state->tileCount)
+                    continue;
 
-            if ((adj->flags & TILE_FLAG_SPACE) && config->spacingEnabled)
+                TileAtmosData* adj = &state->tiles[adjIdx];
+                int back = opposite_dir(j);
+                if (!(adj->adjacentBits & (1 << back)) || adj->adjacentIndices[back] != exploringIdx)
+                    complete = false;
+
+                if (adj->lastQueueCycle == queueCycle)
+                    continue;
+                if (zone && tileCount >= walkLimit)
+                    continue;
+
+                adj->moleDelta = 0;
+                adj->fastDone = 0;
+                for (int k = 0; k < ATMOS_DIRECTIONS; k++)
+                    adj->transferDirections[k] = 0;
+                adj->lastQueueCycle = queueCycle;
+
+                if (tileCount < walkLimit)
+                    equalizeTiles[tileCount++] = adj;
+                else
+                    complete = false;
+
+                if (adj->flags & TILE_FLAG_SPACE)
+                {
+                    if (config->spacingEnabled)
+                    {
+                        explosive_depressurize(state, startTileIndex, config);
+                        return;
+                    }
+                    complete = false;
+                }
+            }
+        }
+
+        if (zone)
+        {
+            state->stats.monstermosZoneCacheHits++;
+        }
+        else if (complete)
+        {
+            int32_t* members = begin_zone_record(state, zones, tileCount);
+            for (int i = 0; i < tileCount; i++)
             {
-                explosive_depressurize(state, startTileIndex, config);
-                return;
+                members[i] = (int32_t)(equalizeTiles[i] - state->tiles);
+                zones->zoneOfTile[members[i]] = zones->zoneCount;
             }
+
+            MonstermosZone record = {};
+            record.touchedCount = tileCount;
+            record.memberCount = tileCount;
+            record.checkedCount = tileCount;
+            commit_zone_record(state, zones, startTileIndex, &record, tileCount);
         }
     }
 
+    if (tileCount > config->constants.monstermosTileLimit && config->monstermosCoarseEnabled)
+    {
+        equalize_pressure_coarse(state, startTileIndex, equalizeTiles, tileCount, config);
+        return;
+    }
+
     if (tileCount > config->constants.monstermosTileLimit)
     {
         for (int i = config->constants.monstermosTileLimit; i < tileCount; i++)
         {
-            TileAtmosData* otherTile = s_equalizeTiles[i];
+            TileAtmosData* otherTile = equalizeTiles[i];
             if (otherTile)
                 otherTile->lastQueueCycle = 0;
         }
         tileCount = config->constants.monstermosTileLimit;
     }
 
+    state->stats.monstermosZones++;
+    state->stats.monstermosZoneTiles += tileCount;
+    if (tileCount > state->stats.monstermosLargestZone)
+        state->stats.monstermosLargestZone = tileCount;
+
     float averageMoles = totalMoles / tileCount;
     int giverTilesLength = 0;
     int takerTilesLength = 0;
 
     for (int i = 0; i < tileCount; i++)
     {
-        TileAtmosData* otherTile = s_equalizeTiles[i];
+        TileAtmosData* otherTile = equalizeTiles[i];
+        archive_tile_epoch(state, (int32_t)(otherTile - state->tiles));
         otherTile->lastCycle = state->updateCounter;
         otherTile->moleDelta -= averageMoles;
 
         if (otherTile->moleDelta > 0)
-            s_equalizeGiverTiles[giverTilesLength++] = otherTile;
+            giverTiles[giverTilesLength++] = otherTile;
         else
-            s_equalizeTakerTiles[takerTilesLength++] = otherTile;
+            takerTiles[takerTilesLength++] = otherTile;
     }
 
     float logN = log2f((float)tileCount);
 
     if (giverTilesLength > logN && takerTilesLength > logN)
     {
-        qsort(s_equalizeTiles, tileCount, sizeof(TileAtmosData*), tile_mole_delta_compare);
+        sort_tiles_by_mole_delta(equalizeTiles, tileCount, scratch);
 
         for (int i = 0; i < tileCount; i++)
         {
-            TileAtmosData* otherTile = s_equalizeTiles[i];
+            TileAtmosData* otherTile = equalizeTiles[i];
             otherTile->fastDone = 1;
 
             if (otherTile->moleDelta <= 0)
@@ -201,185 +659,35 @@ void equalize_pressure_in_zone(GridAtmosState* state, int32_t startTileIndex, co
 
         for (int i = 0; i < tileCount; i++)
         {
-            TileAtmosData* otherTile = s_equalizeTiles[i];
+            TileAtmosData* otherTile = equalizeTiles[i];
             if (otherTile->moleDelta > 0)
-                s_equalizeGiverTiles[giverTilesLength++] = otherTile;
+                giverTiles[giverTilesLength++] = otherTile;
             else
-                s_equalizeTakerTiles[takerTilesLength++] = otherTile;
+                takerTiles[takerTilesLength++] = otherTile;
         }
     }
 
     if (giverTilesLength < takerTilesLength)
     {
-        for (int j = 0; j < giverTilesLength; j++)
-        {
-            TileAtmosData* giver = s_equalizeGiverTiles[j];
-            giver->currentTransferDirection = -1;
-            giver->currentTransferAmount = 0;
-
-            int64_t queueCycleSlow = ++state->equalizationQueueCycle;
-            int queueLength = 0;
-            s_equalizeQueue[queueLength++] = giver;
-            giver->lastSlowQueueCycle = queueCycleSlow;
-
-            for (int i = 0; i < queueLength; i++)
-            {
-                if (giver->moleDelta <= 0)
-                    break;
-
-                TileAtmosData* otherTile = s_equalizeQueue[i];
-
-                for (int k = 0; k < ATMOS_DIRECTIONS; k++)
-                {
-                    if (giver->moleDelta <= 0)
-                        break;
-
-                    if (!(otherTile->adjacentBits & (1 << k)))
-                        continue;
-
-                    int32_t adjIdx = otherTile->adjacentIndices[k];
-                    if (adjIdx < 0 || adjIdx >= state->tileCount)
-                        continue;
-
-                    TileAtmosData* otherTile2 = &state->tiles[adjIdx];
-                    if (otherTile2->lastQueueCycle != queueCycle)
-                        continue;
-                    if (otherTile2->lastSlowQueueCycle == queueCycleSlow)
-                        continue;
-
-                    s_equalizeQueue[queueLength++] = otherTile2;
-                    otherTile2->lastSlowQueueCycle = queueCycleSlow;
-                    otherTile2->currentTransferDirection = opposite_dir(k);
-                    otherTile2->currentTransferAmount = 0;
-
-                    if (otherTile2->moleDelta < 0)
-                    {
-                        if (-otherTile2->moleDelta > giver->moleDelta)
-                        {
-                            otherTile2->currentTransferAmount -= giver->moleDelta;
-                            otherTile2->moleDelta += giver->moleDelta;
-                            giver->moleDelta = 0;
-                        }
-                        else
-                        {
-                            otherTile2->currentTransferAmount += otherTile2->moleDelta;
-                            giver->moleDelta += otherTile2->moleDelta;
-                            otherTile2->moleDelta = 0;
-                        }
-                    }
-                }
-            }
-
-            for (int i = queueLength - 1; i >= 0; i--)
-            {
-                TileAtmosData* otherTile = s_equalizeQueue[i];
-                if (otherTile->currentTransferAmount == 0 || otherTile->currentTransferDirection < 0)
-                    continue;
-
-                int dir = otherTile->currentTransferDirection;
-                int32_t adjIdx = otherTile->adjacentIndices[dir];
-                if (adjIdx < 0 || adjIdx >= state->tileCount)
-                    continue;
-
-                TileAtmosData* adj = &state->tiles[adjIdx];
-                adjust_eq_movement(otherTile, adj, dir, otherTile->currentTransferAmount);
-                adj->currentTransferAmount += otherTile->currentTransferAmount;
-                otherTile->currentTransferAmount = 0;
-            }
-        }
+        settle_nearest_sources(state, scratch, giverTiles, giverTilesLength, 1.0f, queueCycle);
+        settle_residual_flow(state, scratch, giverTiles, giverTilesLength, 1.0f, queueCycle);
     }
     else
     {
-        for (int j = 0; j < takerTilesLength; j++)
-        {
-            TileAtmosData* taker = s_equalizeTakerTiles[j];
-            taker->currentTransferDirection = -1;
-            taker->currentTransferAmount = 0;
-
-            int64_t queueCycleSlow = ++state->equalizationQueueCycle;
-            int queueLength = 0;
-            s_equalizeQueue[queueLength++] = taker;
-            taker->lastSlowQueueCycle = queueCycleSlow;
-
-            for (int i = 0; i < queueLength; i++)
-            {
-                if (taker->moleDelta >= 0)
-                    break;
-
-                TileAtmosData* otherTile = s_equalizeQueue[i];
-
-                for (int k = 0; k < ATMOS_DIRECTIONS; k++)
-                {
-                    if (taker->moleDelta >= 0)
-                        break;
-
-                    if (!(otherTile->adjacentBits & (1 << k)))
-                        continue;
-
-                    int32_t adjIdx = otherTile->adjacentIndices[k];
-                    if (adjIdx < 0 || adjIdx >= state->tileCount)
-                        continue;
-
-                    TileAtmosData* otherTile2 = &state->tiles[adjIdx];
-                    if (otherTile2->adjacentBits == 0)
-                        continue;
-                    if (otherTile2->lastQueueCycle != queueCycle)
-                        continue;
-                    if (otherTile2->lastSlowQueueCycle == queueCycleSlow)
-                        continue;
-
-                    s_equalizeQueue[queueLength++] = otherTile2;
-                    otherTile2->lastSlowQueueCycle = queueCycleSlow;
-                    otherTile2->currentTransferDirection = opposite_dir(k);
-                    otherTile2->currentTransferAmount = 0;
-
-                    if (otherTile2->moleDelta > 0)
-                    {
-                        if (otherTile2->moleDelta > -taker->moleDelta)
-                        {
-                            otherTile2->currentTransferAmount -= taker->moleDelta;
-                            otherTile2->moleDelta += taker->moleDelta;
-                            taker->moleDelta = 0;
-                        }
-                        else
-                        {
-                            otherTile2->currentTransferAmount += otherTile2->moleDelta;
-                            taker->moleDelta += otherTile2->moleDelta;
-                            otherTile2->moleDelta = 0;
-                        }
-                    }
-                }
-            }
-
-            for (int i = queueLength - 1; i >= 0; i--)
-            {
-                TileAtmosData* otherTile = s_equalizeQueue[i];
-                if (otherTile->currentTransferAmount == 0 || otherTile->currentTransferDirection < 0)
-                    continue;
-
-                int dir = otherTile->currentTransferDirection;
-                int32_t adjIdx = otherTile->adjacentIndices[dir];
-                if (adjIdx < 0 || adjIdx >= state->tileCount)
-                    continue;
-
-                TileAtmosData* adj = &state->tiles[adjIdx];
-                adjust_eq_movement(otherTile, adj, dir, otherTile->currentTransferAmount);
-                adj->currentTransferAmount += otherTile->currentTransferAmount;
-                otherTile->currentTransferAmount = 0;
-            }
-        }
+        settle_nearest_sources(state, scratch, takerTiles, takerTilesLength, -1.0f, queueCycle);
+        settle_residual_flow(state, scratch, takerTiles, takerTilesLength, -1.0f, queueCycle);
     }
 
     for (int i = 0; i < tileCount; i++)
     {
-        TileAtmosData* otherTile = s_equalizeTiles[i];
+        TileAtmosData* otherTile = equalizeTiles[i];
         int32_t otherIdx = (int32_t)(otherTile - state->tiles);
         finalize_eq(state, otherIdx, config);
     }
 
     for (int i = 0; i < tileCount; i++)
     {
-        TileAtmosData* otherTile = s_equalizeTiles[i];
+        TileAtmosData* otherTile = equalizeTiles[i];
         int32_t otherIdx = (int32_t)(otherTile - state->tiles);
 
         for (int j = 0; j < ATMOS_DIRECTIONS; j++)
@@ -403,14 +711,6 @@ void equalize_pressure_in_zone(GridAtmosState* state, int32_t startTileIndex, co
             break;
         }
     }
-
-    for (int i = 0; i < 2000; i++)
-    {
-        s_equalizeTiles[i] = nullptr;
-        s_equalizeGiverTiles[i] = nullptr;
-        s_equalizeTakerTiles[i] = nullptr;
-        s_equalizeQueue[i] = nullptr;
-    }
 }
 
 void explosive_depressurize(GridAtmosState* state, int32_t startTileIndex, const AtmosConfig* config)
@@ -421,105 +721,179 @@ void explosive_depressurize(GridAtmosState* state, int32_t startTileIndex, const
     if (!config->spacingEnabled)
         return;
 
+    state->stats.depressurizations++;
+
     TileAtmosData* startTile = &state->tiles[startTileIndex];
 
+    MonstermosScratch* scratch = ensure_monstermos_scratch(state, config);
+    TileAtmosData** depressurizeTiles = scratch->depressurizeTiles;
+    TileAtmosData** spaceTiles = scratch->spaceTiles;
+    TileAtmosData** progressionOrder = scratch->progressionOrder;
+
     int64_t queueCycle = ++state->equalizationQueueCycle;
     float totalMolesRemoved = 0.0f;
 
-    int tileCount = 0;
-    int spaceTileCount = 0;
-
-    s_depressurizeTiles[tileCount++] = startTile;
     startTile->lastQueueCycle = queueCycle;
     startTile->currentTransferDirection = -1;
 
-    for (int i = 0; i < tileCount; i++)
+    int progressionCount = 0;
+
+    MonstermosZone* zone = find_cached_zone(state, &scratch->depressurizeZones, startTileIndex, config);
+    if (zone)
     {
-        TileAtmosData* otherTile = s_depressurizeTiles[i];
-        otherTile->lastCycle = state->updateCounter;
-        otherTile->currentTransferDirection = -1;
+        const int32_t* touched = scratch->depressurizeZones.members + zone->firstMember;
+        const int32_t* explored = touched + zone->touchedCount;
+        const int32_t* progression = explored + zone->memberCount;
 
-        if (!(otherTile->flags & TILE_FLAG_SPACE))
+        for (int i = 0; i < zone->touchedCount; i++)
         {
-            for (int j = 0; j < ATMOS_DIRECTIONS; j++)
+            TileAtmosData* otherTile = &state->tiles[touched[i]];
+            otherTile->lastQueueCycle = queueCycle;
+            otherTile->currentTransferDirection = -1;
+            otherTile->currentTransferAmount = 0;
+        }
+
+        for (int i = 0; i < zone->memberCount; i++)
+        {
+            TileAtmosData* otherTile = &state->tiles[explored[i]];
+            otherTile->lastCycle = state->updateCounter;
+            otherTile->currentTransferDirection = -1;
+        }
+
+        int64_t queueCycleSlow = ++state->equalizationQueueCycle;
+        progressionCount = zone->progressionCount;
+
+        for (int i = 0; i < progressionCount; i++)
+        {
+            TileAtmosData* otherTile = &state->tiles[progression[i] >> 3];
+            otherTile->lastSlowQueueCycle = queueCycleSlow;
+            otherTile->currentTransferDirection = (progression[i] & 7) - 1;
+            if (i >= zone->seedCount)
+                otherTile->currentTransferAmount = 0.0f;
+            progressionOrder[i] = otherTile;
+        }
+
+        state->stats.depressurizeCacheHits++;
+    }
+    else
+    {
+        int32_t* touched = begin_zone_record(state, &scratch->depressurizeZones,
+                                             scratch->queueCapacity * 2 + scratch->zoneCapacity);
+        int32_t touchedCount = 0;
+        int tileCount = 0;
+        int exploredCount = 0;
+        int spaceTileCount = 0;
+
+        depressurizeTiles[tileCount++] = startTile;
+
+        while (exploredCount < tileCount)
+        {
+            TileAtmosData* otherTile = depressurizeTiles[exploredCount++];
+            otherTile->lastCycle = state->updateCounter;
+            otherTile->currentTransferDirection = -1;
+
+            if (!(otherTile->flags & TILE_FLAG_SPACE))
             {
-                int32_t adjIdx = otherTile->adjacentIndices[j];
-                if (adjIdx < 0 || adjIdx >= state->tileCount)
-                    continue;
+                for (int j = 0; j < ATMOS_DIRECTIONS; j++)
+                {
+                    int32_t adjIdx = otherTile->adjacentIndices[j];
+                    if (adjIdx < 0 || adjIdx >= state->tileCount)
+                        continue;
 
-                TileAtmosData* otherTile2 = &state->tiles[adjIdx];
-                if (otherTile2->lastQueueCycle == queueCycle)
-                    continue;
+                    TileAtmosData* otherTile2 = &state->tiles[adjIdx];
+                    if (otherTile2->lastQueueCycle == queueCycle)
+                        continue;
 
-                if (!(otherTile->adjacentBits & (1 << j)))
-                    continue;
+                    if (!(otherTile->adjacentBits & (1 << j)))
+                        continue;
 
-                otherTile2->lastQueueCycle = queueCycle;
-                otherTile2->currentTransferDirection = -1;
-                otherTile2->currentTransferAmount = 0;
+                    otherTile2->lastQueueCycle = queueCycle;
+                    otherTile2->currentTransferDirection = -1;
+                    otherTile2->currentTransferAmount = 0;
+                    touched[touchedCount++] = adjIdx;
 
-                if (tileCount < config->constants.monstermosHardTileLimit)
-                    s_depressurizeTiles[tileCount++] = otherTile2;
+                    if (tileCount < config->constants.monstermosHardTileLimit)
+                        depressurizeTiles[tileCount++] = otherTile2;
+                }
+            }
+            else
+            {
+                spaceTiles[spaceTileCount++] = otherTile;
             }
+
+            if (tileCount >= config->constants.monstermosHardTileLimit ||
+                spaceTileCount >= config->constants.monstermosHardTileLimit)
+                break;
         }
-        else
+
+        int64_t queueCycleSlow = ++state->equalizationQueueCycle;
+
+        for (int i = 0; i < spaceTileCount; i++)
         {
-            s_depressurizeSpaceTiles[spaceTileCount++] = otherTile;
+            TileAtmosData* otherTile = spaceTiles[i];
+            progressionOrder[progressionCount++] = otherTile;
+            otherTile->lastSlowQueueCycle = queueCycleSlow;
+            otherTile->currentTransferDirection = -1;
         }
 
-        if (tileCount >= config->constants.monstermosHardTileLimit ||
-            spaceTileCount >= config->constants.monstermosHardTileLimit)
-            break;
-    }
-
-    int64_t queueCycleSlow = ++state->equalizationQueueCycle;
-    int progressionCount = 0;
+        for (int i = 0; i < progressionCount; i++)
+        {
+            TileAtmosData* otherTile = progressionOrder[i];
 
-    for (int i = 0; i < spaceTileCount; i++)
-    {
-        TileAtmosData* otherTile = s_depressurizeSpaceTiles[i];
-        s_depressurizeProgressionOrder[progressionCount++] = otherTile;
-        otherTile->lastSlowQueueCycle = queueCycleSlow;
-        otherTile->currentTransferDirection = -1;
-    }
+            for (int j = 0; j < ATMOS_DIRECTIONS; j++)
+            {
+                if (!(otherTile->adjacentBits & (1 << j)) && !(otherTile->flags & TILE_FLAG_SPACE))
+                    continue;
 
-    for (int i = 0; i < progressionCount; i++)
-    {
-        TileAtmosData* otherTile = s_depressurizeProgressionOrder[i];
+                int32_t adjIdx = otherTile->adjacentIndices[j];
+                if (adjIdx < 0 || adjIdx >= state->tileCount)
+                    continue;
 
-        for (int j = 0; j < ATMOS_DIRECTIONS; j++)
-        {
-            if (!(otherTile->adjacentBits & (1 << j)) && !(otherTile->flags & TILE_FLAG_SPACE))
-                continue;
+                TileAtmosData* tile2 = &state->tiles[adjIdx];
+                if (tile2->lastQueueCycle != queueCycle)
+                    continue;
+                if (tile2->lastSlowQueueCycle == queueCycleSlow)
+                    continue;
+                if (tile2->flags & TILE_FLAG_SPACE)
+                    continue;
 
-            int32_t adjIdx = otherTile->adjacentIndices[j];
-            if (adjIdx < 0 || adjIdx >= state->tileCount)
-                continue;
+                tile2->currentTransferDirection = opposite_dir(j);
+                tile2->currentTransferAmount = 0.0f;
+                tile2->lastSlowQueueCycle = queueCycleSlow;
+                progressionOrder[progressionCount++] = tile2;
+            }
+        }
 
-            TileAtmosData* tile2 = &state->tiles[adjIdx];
-            if (tile2->lastQueueCycle != queueCycle)
-                continue;
-            if (tile2->lastSlowQueueCycle == queueCycleSlow)
-                continue;
-            if (tile2->flags & TILE_FLAG_SPACE)
-                continue;
+        int32_t* explored = touched + touchedCount;
+        for (int i = 0; i < exploredCount; i++)
+            explored[i] = (int32_t)(depressurizeTiles[i] - state->tiles);
 
-            tile2->currentTransferDirection = opposite_dir(j);
-            tile2->currentTransferAmount = 0.0f;
-            tile2->lastSlowQueueCycle = queueCycleSlow;
-            s_depressurizeProgressionOrder[progressionCount++] = tile2;
+        int32_t* progression = explored + exploredCount;
+        for (int i = 0; i < progressionCount; i++)
+        {
+            TileAtmosData* otherTile = progressionOrder[i];
+            progression[i] = (int32_t)(otherTile - state->tiles) * 8 + otherTile->currentTransferDirection + 1;
         }
+
+        MonstermosZone record = {};
+        record.touchedCount = touchedCount;
+        record.memberCount = exploredCount;
+        record.progressionCount = progressionCount;
+        record.seedCount = spaceTileCount;
+        record.checkedCount = touchedCount + exploredCount;
+        commit_zone_record(state, &scratch->depressurizeZones, startTileIndex, &record, touchedCount + exploredCount + progressionCount);
     }
 
     for (int i = progressionCount - 1; i >= 0; i--)
     {
-        TileAtmosData* otherTile = s_depressurizeProgressionOrder[i];
+        TileAtmosData* otherTile = progressionOrder[i];
         if (otherTile->currentTransferDirection < 0)
             continue;
 
         int32_t otherIdx = (int32_t)(otherTile - state->tiles);
         int dir = otherTile->currentTransferDirection;
         int32_t adjIdx = otherTile->adjacentIndices[dir];
+        archive_tile_epoch(state, otherIdx);
 
         if (adjIdx < 0 || adjIdx >= state->tileCount)
         {
@@ -532,8 +906,10 @@ void explosive_depressurize(GridAtmosState* state, int32_t startTileIndex, const
         }
 
         TileAtmosData* otherTile2 = &state->tiles[adjIdx];
+        archive_tile_epoch(state, adjIdx);
 
-        state->highPressureTiles[state->highPressureTileCount++] = otherIdx;
+        tile_set_insert(&state->highPressureTiles, &state->highPressureTileCount, &state->highPressureTileCapacity,
+                        state->highPressureSlots, otherIdx);
         add_active_tile_impl(state, otherIdx);
 
         float sum = tile_total_moles(otherTile);
@@ -571,7 +947,7 @@ void explosive_depressurize(GridAtmosState* state, int32_t startTileIndex, const
             float ratio = sum / currentMoles;
             if (ratio > 1.0f) ratio = 1.0f;
 
-            for (int g = 0; g < ATMOS_GAS_COUNT; g++)
+            for (int g = 0; g < state->gasCount; g++)
             {
                 float transfer = otherTile->moles[g] * ratio;
                 otherTile->moles[g] -= transfer;
@@ -592,14 +968,6 @@ void explosive_depressurize(GridAtmosState* state, int32_t startTileIndex, const
             otherTile->temperature = config->constants.TCMB;
         }
     }
-
-    for (int i = 0; i < 2000; i++)
-    {
-        s_depressurizeTiles[i] = nullptr;
-        s_depressurizeSpaceTiles[i] = nullptr;
-    }
-    for (int i = 0; i < 4000; i++)
-        s_depressurizeProgressionOrder[i] = nullptr;
 }
 
 void adjust_eq_movement(TileAtmosData* tile, TileAtmosData* adj, int direction, float amount)
@@ -671,7 +1039,7 @@ void finalize_eq(GridAtmosState* state, int32_t tileIndex, const AtmosConfig* co
         if (!(tile->flags & TILE_FLAG_IMMUTABLE) && !(otherTile->flags & TILE_FLAG_IMMUTABLE))
         {
             float transferMoles[ATMOS_GAS_ARRAY_SIZE] = {0};
-            for (int g = 0; g < ATMOS_GAS_COUNT; g++)
+            for (int g = 0; g < state->gasCount; g++)
             {
                 float transfer = tile->moles[g] * ratio;
                 transferMoles[g] = transfer;
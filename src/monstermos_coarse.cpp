@@ -0,0 +1,276 @@
+#include "atmos_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+static int32_t block_coordinate(int32_t value, int32_t blockSize)
+{
+    return value >= 0 ? value / blockSize : -((blockSize - 1 - value) / blockSize);
+}
+
+static void ensure_coarse_tiles(MonstermosScratch* scratch, int32_t needed)
+{
+    if (scratch->coarseTileCapacity >= needed)
+        return;
+
+    int32_t newCapacity = scratch->coarseTileCapacity ? scratch->coarseTileCapacity * 2 : 1024;
+    while (newCapacity < needed) newCapacity *= 2;
+
+    scratch->coarseTiles = (int32_t*)realloc(scratch->coarseTiles, newCapacity * sizeof(int32_t));
+    scratch->coarseBlocks = (CoarseBlock*)realloc(scratch->coarseBlocks, newCapacity * sizeof(CoarseBlock));
+    scratch->coarseTileCapacity = newCapacity;
+}
+
+static void move_block_gas(CoarseBlock* from, CoarseBlock* to, float amount, int32_t gasCount)
+{
+    if (from->totalMoles <= 0.0f)
+        return;
+
+    float ratio = amount / from->totalMoles;
+    if (ratio > 1.0f) ratio = 1.0f;
+
+    for (int g = 0; g < gasCount; g++)
+    {
+        float transfer = from->moles[g] * ratio;
+        from->moles[g] -= transfer;
+        to->moles[g] += transfer;
+    }
+
+    float energy = from->energy * ratio;
+    from->energy -= energy;
+    to->energy += energy;
+
+    float moved = from->totalMoles * ratio;
+    from->totalMoles -= moved;
+    to->totalMoles += moved;
+}
+
+// Flood-fills the zone tiles reachable from seed without leaving its block cell, so tiles
+// split by a wall inside one cell end up in separate blocks.
+static void fill_coarse_block(GridAtmosState* state, MonstermosScratch* scratch, int32_t* orderedCount, int32_t seed,
+                              int64_t memberCycle, int64_t assignedCycle, int32_t blockSize, const AtmosConfig* config)
+{
+    int32_t* ordered = scratch->coarseTiles;
+    CoarseBlock* block = &scratch->coarseBlocks[scratch->coarseBlockCount - 1];
+    int32_t gasCount = state->gasCount;
+
+    block->firstTile = *orderedCount;
+    state->tiles[seed].lastSlowQueueCycle = assignedCycle;
+    ordered[(*orderedCount)++] = seed;
+
+    for (int32_t i = block->firstTile; i < *orderedCount; i++)
+    {
+        TileAtmosData* tile = &state->tiles[ordered[i]];
+        archive_tile_epoch(state, ordered[i]);
+        tile->lastCycle = state->updateCounter;
+
+        int32_t cellX = block_coordinate(tile->gridX, blockSize);
+        int32_t cellY = block_coordinate(tile->gridY, blockSize);
+
+        for (int j = 0; j < ATMOS_DIRECTIONS; j++)
+        {
+            if (!(tile->adjacentBits & (1 << j)))
+                continue;
+
+            int32_t adjIdx = tile->adjacentIndices[j];
+            if (adjIdx < 0 || adjIdx >= state->tileCount)
+                continue;
+
+            TileAtmosData* adj = &state->tiles[adjIdx];
+            if (adj->lastSlowQueueCycle != memberCycle)
+                continue;
+            if (block_coordinate(adj->gridX, blockSize) != cellX || block_coordinate(adj->gridY, blockSize) != cellY)
+                continue;
+
+            adj->lastSlowQueueCycle = assignedCycle;
+            ordered[(*orderedCount)++] = adjIdx;
+        }
+
+        if (tile->flags & TILE_FLAG_IMMUTABLE)
+            continue;
+
+        float tileMoles = 0.0f;
+        for (int g = 0; g < gasCount; g++)
+        {
+            block->moles[g] += tile->moles[g];
+            tileMoles += tile->moles[g];
+        }
+
+        block->energy += tile->temperature * get_heat_capacity_impl(tile->moles, config->gasSpecificHeats, false);
+        block->totalMoles += tileMoles;
+        block->tileCount++;
+    }
+
+    block->tileSpan = *orderedCount - block->firstTile;
+}
+
+static CoarseBlock* open_coarse_block(MonstermosScratch* scratch, int32_t parent, int32_t linkTile, int32_t linkDirection)
+{
+    CoarseBlock* created = &scratch->coarseBlocks[scratch->coarseBlockCount++];
+    memset(created, 0, sizeof(CoarseBlock));
+    created->parent = parent;
+    created->linkTile = linkTile;
+    created->linkDirection = linkDirection;
+    return created;
+}
+
+void equalize_pressure_coarse(GridAtmosState* state, int32_t startTileIndex, TileAtmosData* const* zoneTiles, int32_t zoneCount,
+                              const AtmosConfig* config)
+{
+    if (!state || !config || !zoneTiles || zoneCount <= 0 || startTileIndex < 0 || startTileIndex >= state->tileCount)
+        return;
+
+    MonstermosScratch* scratch = ensure_monstermos_scratch(state, config);
+    int32_t blockSize = config->constants.monstermosCoarseBlockSize;
+    if (blockSize < 1)
+        blockSize = 1;
+
+    ensure_coarse_tiles(scratch, zoneCount);
+
+    int64_t memberCycle = ++state->equalizationQueueCycle;
+    int64_t assignedCycle = ++state->equalizationQueueCycle;
+    for (int32_t i = 0; i < zoneCount; i++)
+        zoneTiles[i]->lastSlowQueueCycle = memberCycle;
+
+    TileAtmosData* startTile = &state->tiles[startTileIndex];
+    int32_t* ordered = scratch->coarseTiles;
+    int32_t orderedCount = 0;
+
+    scratch->coarseBlockCount = 0;
+    open_coarse_block(scratch, -1, -1, -1);
+    fill_coarse_block(state, scratch, &orderedCount, startTileIndex, memberCycle, assignedCycle, blockSize, config);
+
+    for (int32_t b = 0; b < scratch->coarseBlockCount; b++)
+    {
+        int32_t first = scratch->coarseBlocks[b].firstTile;
+        int32_t span = scratch->coarseBlocks[b].tileSpan;
+
+        for (int32_t i = first; i < first + span; i++)
+        {
+            const TileAtmosData* tile = &state->tiles[ordered[i]];
+
+            for (int j = 0; j < ATMOS_DIRECTIONS; j++)
+            {
+                if (!(tile->adjacentBits & (1 << j)))
+                    continue;
+
+                int32_t adjIdx = tile->adjacentIndices[j];
+                if (adjIdx < 0 || adjIdx >= state->tileCount)
+                    continue;
+                if (state->tiles[adjIdx].lastSlowQueueCycle != memberCycle)
+                    continue;
+
+                open_coarse_block(scratch, b, ordered[i], j);
+                fill_coarse_block(state, scratch, &orderedCount, adjIdx, memberCycle, assignedCycle, blockSize, config);
+            }
+        }
+    }
+
+    CoarseBlock* blocks = scratch->coarseBlocks;
+    int32_t blockCount = scratch->coarseBlockCount;
+    int32_t gasCount = state->gasCount;
+
+    state->stats.monstermosZones++;
+    state->stats.monstermosCoarseZones++;
+    state->stats.monstermosZoneTiles += orderedCount;
+    if (orderedCount > state->stats.monstermosLargestZone)
+        state->stats.monstermosLargestZone = orderedCount;
+
+    int32_t mutableCount = 0;
+    float totalMoles = 0.0f;
+    for (int32_t b = 0; b < blockCount; b++)
+    {
+        mutableCount += blocks[b].tileCount;
+        totalMoles += blocks[b].totalMoles;
+    }
+
+    if (mutableCount == 0)
+        return;
+
+    float averageMoles = totalMoles / mutableCount;
+
+    for (int32_t b = 0; b < blockCount; b++)
+        blocks[b].flow = blocks[b].totalMoles - averageMoles * blocks[b].tileCount;
+
+    for (int32_t b = blockCount - 1; b > 0; b--)
+        blocks[blocks[b].parent].flow += blocks[b].flow;
+
+    for (int32_t b = blockCount - 1; b > 0; b--)
+    {
+        if (blocks[b].flow > 0.0f)
+            move_block_gas(&blocks[b], &blocks[blocks[b].parent], blocks[b].flow, gasCount);
+    }
+
+    for (int32_t b = 1; b < blockCount; b++)
+    {
+        if (blocks[b].flow < 0.0f)
+            move_block_gas(&blocks[blocks[b].parent], &blocks[b], -blocks[b].flow, gasCount);
+    }
+
+    for (int32_t b = 1; b < blockCount; b++)
+    {
+        const CoarseBlock* block = &blocks[b];
+        if (block->flow == 0.0f)
+            continue;
+
+        int32_t parentTile = block->linkTile;
+        int dir = block->linkDirection;
+        int32_t childTile = state->tiles[parentTile].adjacentIndices[dir];
+
+        if (block->flow > 0.0f)
+            consider_pressure_difference(state, childTile, opposite_dir(dir), block->flow);
+        else
+            consider_pressure_difference(state, parentTile, dir, -block->flow);
+    }
+
+    for (int32_t b = 0; b < blockCount; b++)
+    {
+        CoarseBlock* block = &blocks[b];
+        if (block->tileCount == 0)
+            continue;
+
+        float heatCapacity = get_heat_capacity_impl(block->moles, config->gasSpecificHeats, false);
+        float temperature = heatCapacity > config->constants.minimumHeatCapacity ? block->energy / heatCapacity : 0.0f;
+
+        float share = 1.0f / block->tileCount;
+        for (int g = 0; g < gasCount; g++)
+            block->moles[g] *= share;
+
+        for (int32_t i = block->firstTile; i < block->firstTile + block->tileSpan; i++)
+        {
+            TileAtmosData* tile = &state->tiles[ordered[i]];
+            if (tile->flags & TILE_FLAG_IMMUTABLE)
+                continue;
+
+            for (int g = 0; g < gasCount; g++)
+                tile->moles[g] = block->moles[g];
+
+            if (temperature > 0.0f)
+                tile->temperature = temperature;
+        }
+    }
+
+    for (int32_t i = 0; i < orderedCount; i++)
+    {
+        const TileAtmosData* tile = &state->tiles[ordered[i]];
+
+        for (int j = 0; j < ATMOS_DIRECTIONS; j++)
+        {
+            if (!(tile->adjacentBits & (1 << j)))
+                continue;
+
+            int32_t adjIdx = tile->adjacentIndices[j];
+            if (adjIdx < 0 || adjIdx >= state->tileCount)
+                continue;
+
+            TileAtmosData* other = &state->tiles[adjIdx];
+            if (other->adjacentBits == 0)
+                continue;
+
+            if (compare_exchange(other, startTile, config) == -2)
+                continue;
+
+            add_active_tile_impl(state, adjIdx);
+            break;
+        }
+    }
+}
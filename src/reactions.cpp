@@ -1,8 +1,7 @@
-#include "atmos_internal.h"
-
-#define REACTION_NONE      0
-#define REACTION_REACTING  1
-#define REACTION_STOP      2
+#include "atmos_kernels.h"
+#include <float.h>
+#include <stddef.h>
+#include <string.h>
 
 int plasma_fire_reaction(TileAtmosData* tile, const AtmosConfig* config)
 {
@@ -283,47 +282,316 @@ int ammonia_oxygen_reaction(TileAtmosData* tile, const AtmosConfig* config)
     return REACTION_REACTING;
 }
 
-int react_impl(TileAtmosData* tile, const AtmosConfig* config)
+typedef int (*ReactionFn)(TileAtmosData* tile, const AtmosConfig* config);
+
+#define REACTION_UNBOUNDED       -1
+#define REACTION_ABSOLUTE        -2
+#define REACTION_CONSTANT(field) ((int32_t)offsetof(AtmosConstants, field))
+#define GAS_BIT(gas)             (1u << (gas))
+
+struct CustomReaction
 {
-    if (!tile || !config)
-        return REACTION_NONE;
+    uint8_t reactantGases[ATMOS_GAS_ARRAY_SIZE];
+    float reactantCoefficients[ATMOS_GAS_ARRAY_SIZE];
+    int32_t reactantCount;
+    uint8_t productGases[ATMOS_GAS_ARRAY_SIZE];
+    float productCoefficients[ATMOS_GAS_ARRAY_SIZE];
+    int32_t productCount;
+    float minimumTemperature;
+    float rateCoefficient;
+    float rateTemperatureScale;
+    float energyReleased;
+    int32_t rateFormula;
+};
+
+struct ReactionDescriptor
+{
+    ReactionFn fn;
+    int32_t custom;
+    int32_t priority;
+    uint32_t requiredGases;
+    int32_t minimumTemperatureConstant;
+    float minimumTemperatureOffset;
+    int32_t maximumTemperatureConstant;
+    float maximumTemperatureOffset;
+};
+
+static const ReactionDescriptor s_builtinReactions[ATMOS_REACTION_TYPE_COUNT] =
+{
+    { plasma_fire_reaction, -1, 0, GAS_BIT(GAS_PLASMA) | GAS_BIT(GAS_OXYGEN),
+      REACTION_CONSTANT(plasmaMinimumBurnTemperature), 0.0f, REACTION_UNBOUNDED, 0.0f },
+    { tritium_fire_reaction, -1, 0, GAS_BIT(GAS_TRITIUM) | GAS_BIT(GAS_OXYGEN),
+      REACTION_CONSTANT(plasmaMinimumBurnTemperature), 0.0f, REACTION_UNBOUNDED, 0.0f },
+    { frezon_production_reaction, -1, 0, GAS_BIT(GAS_TRITIUM) | GAS_BIT(GAS_OXYGEN) | GAS_BIT(GAS_NITROGEN),
+      REACTION_UNBOUNDED, 0.0f, REACTION_CONSTANT(frezonCoolMidTemperature), 0.0f },
+    { frezon_coolant_reaction, -1, 0, GAS_BIT(GAS_FREZON) | GAS_BIT(GAS_NITROGEN),
+      REACTION_CONSTANT(frezonCoolLowerTemperature), 0.0f, REACTION_UNBOUNDED, 0.0f },
+    { water_vapor_reaction, -1, 0, GAS_BIT(GAS_WATER_VAPOR),
+      REACTION_UNBOUNDED, 0.0f, REACTION_CONSTANT(T0C), 100.0f },
+    { n2o_decomposition_reaction, -1, 0, GAS_BIT(GAS_N2O),
+      REACTION_CONSTANT(T0C), 250.0f, REACTION_UNBOUNDED, 0.0f },
+    { ammonia_oxygen_reaction, -1, 0, GAS_BIT(GAS_AMMONIA) | GAS_BIT(GAS_OXYGEN),
+      REACTION_CONSTANT(T0C), 100.0f, REACTION_UNBOUNDED, 0.0f },
+};
+
+struct ReactionRegistry
+{
+    ReactionDescriptor reactions[ATMOS_REACTION_MAX_COUNT];
+    CustomReaction custom[ATMOS_REACTION_MAX_COUNT];
+    uint8_t order[ATMOS_REACTION_MAX_COUNT];
+    int32_t count;
+    uint16_t candidates[1u << ATMOS_GAS_ARRAY_SIZE];
 
-    if (tile->flags & TILE_FLAG_IMMUTABLE)
-        return REACTION_NONE;
+    ReactionRegistry()
+    {
+        reset();
+    }
 
-    int result = REACTION_NONE;
-    float energy = get_thermal_energy_impl(tile, config->gasSpecificHeats);
+    void reset()
+    {
+        memcpy(reactions, s_builtinReactions, sizeof(s_builtinReactions));
+        count = ATMOS_REACTION_TYPE_COUNT;
+        rebuild();
+    }
+
+    void rebuild()
+    {
+        for (int32_t i = 0; i < count; i++)
+        {
+            int32_t j = i;
+            while (j > 0 && reactions[order[j - 1]].priority < reactions[i].priority)
+            {
+                order[j] = order[j - 1];
+                j--;
+            }
+            order[j] = (uint8_t)i;
+        }
+
+        for (uint32_t present = 0; present < (1u << ATMOS_GAS_ARRAY_SIZE); present++)
+        {
+            uint16_t mask = 0;
+            for (int32_t i = 0; i < count; i++)
+            {
+                if ((present & reactions[i].requiredGases) == reactions[i].requiredGases)
+                    mask |= (uint16_t)(1u << i);
+            }
+            candidates[present] = mask;
+        }
+    }
+};
 
-    if (energy < 1000.0f)
+static ReactionRegistry s_registry;
+
+static ATMOS_INLINE uint32_t tile_reaction_candidates(const TileAtmosData* tile)
+{
+    return s_registry.candidates[present_gas_mask(tile->moles)];
+}
+
+static float reaction_bound(const AtmosConfig* config, int32_t constant, float offset, float unbounded)
+{
+    if (constant == REACTION_UNBOUNDED)
+        return unbounded;
+
+    if (constant == REACTION_ABSOLUTE)
+        return offset;
+
+    return *(const float*)((const char*)&config->constants + constant) + offset;
+}
+
+static void reaction_window(const ReactionDescriptor* reaction, const AtmosConfig* config, float* minimum, float* maximum)
+{
+    *minimum = reaction_bound(config, reaction->minimumTemperatureConstant, reaction->minimumTemperatureOffset, -FLT_MAX);
+    *maximum = reaction_bound(config, reaction->maximumTemperatureConstant, reaction->maximumTemperatureOffset, FLT_MAX);
+}
+
+static int custom_reaction(TileAtmosData* tile, const AtmosConfig* config, const CustomReaction* reaction)
+{
+    float limit = FLT_MAX;
+    for (int32_t i = 0; i < reaction->reactantCount; i++)
+        limit = simd_min(limit, tile->moles[reaction->reactantGases[i]] / reaction->reactantCoefficients[i]);
+
+    float rate;
+    switch (reaction->rateFormula)
+    {
+        case ATMOS_REACTION_RATE_CONSTANT:
+            rate = reaction->rateCoefficient;
+            break;
+        case ATMOS_REACTION_RATE_TEMPERATURE_SCALED:
+            rate = limit * reaction->rateCoefficient;
+            if (reaction->rateTemperatureScale > 0.0f)
+                rate *= simd_clamp((tile->temperature - reaction->minimumTemperature) / reaction->rateTemperatureScale, 0.0f, 1.0f);
+            break;
+        default:
+            rate = limit * reaction->rateCoefficient;
+            break;
+    }
+
+    rate = simd_min(rate, limit);
+    if (rate < config->constants.gasMinMoles)
         return REACTION_NONE;
 
-    int r = plasma_fire_reaction(tile, config);
-    if (r == REACTION_STOP) return r;
-    if (r != REACTION_NONE) result = r;
+    float heatCapacity = get_heat_capacity_impl(tile->moles, config->gasSpecificHeats, false);
+
+    for (int32_t i = 0; i < reaction->reactantCount; i++)
+        tile->moles[reaction->reactantGases[i]] -= rate * reaction->reactantCoefficients[i];
+
+    for (int32_t i = 0; i < reaction->productCount; i++)
+        tile->moles[reaction->productGases[i]] += rate * reaction->productCoefficients[i];
+
+    if (reaction->energyReleased != 0.0f && heatCapacity > config->constants.minimumHeatCapacity)
+    {
+        tile->temperature += reaction->energyReleased * rate / heatCapacity / config->heatScale;
+        tile->temperature = simd_clamp(tile->temperature, config->constants.TCMB, config->constants.Tmax);
+    }
+
+    return REACTION_REACTING;
+}
+
+static ATMOS_INLINE int run_reaction(int32_t id, TileAtmosData* tile, const AtmosConfig* config)
+{
+    const ReactionDescriptor* reaction = &s_registry.reactions[id];
+    if (reaction->fn)
+        return reaction->fn(tile, config);
+
+    return custom_reaction(tile, config, &s_registry.custom[reaction->custom]);
+}
+
+int32_t register_reaction(const AtmosReactionDefinition* definition)
+{
+    if (!definition || s_registry.count >= ATMOS_REACTION_MAX_COUNT)
+        return -1;
+
+    if (definition->rateFormula < ATMOS_REACTION_RATE_CONSTANT || definition->rateFormula > ATMOS_REACTION_RATE_TEMPERATURE_SCALED)
+        return -1;
+
+    if (!(definition->minimumTemperature <= definition->maximumTemperature) || definition->rateCoefficient <= 0.0f)
+        return -1;
+
+    int32_t id = s_registry.count;
+    CustomReaction* custom = &s_registry.custom[id];
+    memset(custom, 0, sizeof(CustomReaction));
+
+    uint32_t requiredGases = 0;
+    for (int g = 0; g < ATMOS_GAS_ARRAY_SIZE; g++)
+    {
+        float reactant = definition->reactants[g];
+        float product = definition->products[g];
+
+        if (reactant < 0.0f || product < 0.0f)
+            return -1;
+
+        if (reactant > 0.0f)
+        {
+            custom->reactantGases[custom->reactantCount] = (uint8_t)g;
+            custom->reactantCoefficients[custom->reactantCount++] = reactant;
+            requiredGases |= GAS_BIT(g);
+        }
+
+        if (product > 0.0f)
+        {
+            custom->productGases[custom->productCount] = (uint8_t)g;
+            custom->productCoefficients[custom->productCount++] = product;
+        }
+    }
+
+    if (custom->reactantCount == 0)
+        return -1;
+
+    custom->minimumTemperature = definition->minimumTemperature;
+    custom->rateCoefficient = definition->rateCoefficient;
+    custom->rateTemperatureScale = definition->rateTemperatureScale;
+    custom->energyReleased = definition->energyReleased;
+    custom->rateFormula = definition->rateFormula;
+
+    ReactionDescriptor* reaction = &s_registry.reactions[id];
+    reaction->fn = nullptr;
+    reaction->custom = id;
+    reaction->priority = definition->priority;
+    reaction->requiredGases = requiredGases;
+    reaction->minimumTemperatureConstant = REACTION_ABSOLUTE;
+    reaction->minimumTemperatureOffset = definition->minimumTemperature;
+    reaction->maximumTemperatureConstant = REACTION_ABSOLUTE;
+    reaction->maximumTemperatureOffset = definition->maximumTemperature;
+
+    s_registry.count++;
+    s_registry.rebuild();
+    return id;
+}
+
+void reset_reactions()
+{
+    s_registry.reset();
+}
+
+int32_t reaction_count()
+{
+    return s_registry.count;
+}
+
+const uint16_t* reaction_candidate_table()
+{
+    return s_registry.candidates;
+}
 
-    r = tritium_fire_reaction(tile, config);
-    if (r == REACTION_STOP) return r;
-    if (r != REACTION_NONE) result = r;
+// Runs the candidate reactions in priority order; the gas and energy gates live in the
+// per-ISA react kernel.
+int react_candidates(TileAtmosData* tile, const AtmosConfig* config, uint32_t candidates, uint32_t* reactedMask)
+{
+    int result = REACTION_NONE;
 
-    r = frezon_production_reaction(tile, config);
-    if (r == REACTION_STOP) return r;
-    if (r != REACTION_NONE) result = r;
+    for (int32_t k = 0; k < s_registry.count; k++)
+    {
+        int32_t i = s_registry.order[k];
+        if (!(candidates & (1u << i)))
+            continue;
+
+        float minimum, maximum;
+        reaction_window(&s_registry.reactions[i], config, &minimum, &maximum);
+        if (tile->temperature < minimum || tile->temperature > maximum)
+            continue;
 
-    r = frezon_coolant_reaction(tile, config);
-    if (r == REACTION_STOP) return r;
-    if (r != REACTION_NONE) result = r;
+        int r = run_reaction(i, tile, config);
+        if (r == REACTION_NONE)
+            continue;
 
-    r = water_vapor_reaction(tile, config);
-    if (r == REACTION_STOP) return r;
-    if (r != REACTION_NONE) result = r;
+        if (reactedMask)
+            *reactedMask |= 1u << i;
 
-    r = n2o_decomposition_reaction(tile, config);
-    if (r == REACTION_STOP) return r;
-    if (r != REACTION_NONE) result = r;
+        if (r == REACTION_STOP)
+            return r;
 
-    r = ammonia_oxygen_reaction(tile, config);
-    if (r == REACTION_STOP) return r;
-    if (r != REACTION_NONE) result = r;
+        result = r;
+        candidates = tile_reaction_candidates(tile);
+    }
 
     return result;
-}
\ No newline at end of file
+}
+
+int react_tracked(TileAtmosData* tile, const AtmosConfig* config, uint32_t* reactedMask)
+{
+    if (!tile || !config)
+    {
+        if (reactedMask)
+            *reactedMask = 0;
+        return REACTION_NONE;
+    }
+
+    return atmos_kernel_table()->react(tile, config, reactedMask);
+}
+
+int react_impl(TileAtmosData* tile, const AtmosConfig* config)
+{
+    return react_tracked(tile, config, nullptr);
+}
+
+void record_reactions(GridAtmosState* state, uint32_t reactedMask)
+{
+    for (int i = 0; i < ATMOS_REACTION_MAX_COUNT; i++)
+    {
+        if (reactedMask & (1u << i))
+        {
+            state->stats.reactionCounts[i]++;
+            state->stats.reactionsTriggered++;
+        }
+    }
+}
@@ -37,6 +37,8 @@ void superconduct(GridAtmosState* state, int32_t tileIndex, const AtmosConfig* c
 
         if (adjacent->lastCycle < state->updateCounter)
             archive_tile(adjacent);
+        else
+            archive_tile_epoch(state, adjIdx);
 
         neighbor_conduct_with_source(state, adjIdx, tileIndex, config);
         consider_superconductivity(state, adjIdx, false, config);
@@ -75,19 +77,8 @@ bool consider_superconductivity(GridAtmosState* state, int32_t tileIndex, bool s
 
     tile->flags |= TILE_FLAG_SUPERCONDUCT;
 
-    bool found = false;
-    for (int i = 0; i < state->superconductTileCount; i++)
-    {
-        if (state->superconductTiles[i] == tileIndex)
-        {
-            found = true;
-            break;
-        }
-    }
-    if (!found)
-    {
-        state->superconductTiles[state->superconductTileCount++] = tileIndex;
-    }
+    tile_set_insert(&state->superconductTiles, &state->superconductTileCount, &state->superconductTileCapacity,
+                    state->superconductSlots, tileIndex);
 
     return true;
 }
@@ -180,13 +171,6 @@ void finish_superconductivity(GridAtmosState* state, int32_t tileIndex, float te
     {
         tile->flags &= ~TILE_FLAG_SUPERCONDUCT;
 
-        for (int i = 0; i < state->superconductTileCount; i++)
-        {
-            if (state->superconductTiles[i] == tileIndex)
-            {
-                state->superconductTiles[i] = state->superconductTiles[--state->superconductTileCount];
-                break;
-            }
-        }
+        tile_set_remove(state->superconductTiles, &state->superconductTileCount, state->superconductSlots, tileIndex);
     }
 }
\ No newline at end of file
@@ -0,0 +1,254 @@
+#include "atmos_internal.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct PoolJob
+{
+    AtmosJobFn fn;
+    void* context;
+    int32_t count;
+    int32_t grain;
+    int32_t next;
+    std::atomic<int32_t> remaining;
+    PoolJob* nextJob;
+};
+
+struct PoolState
+{
+    std::mutex mutex;
+    std::mutex resizeMutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    std::vector<std::thread> workers;
+    PoolJob* jobs = nullptr;
+    bool stop = false;
+};
+
+// Never destroyed: joining workers from a static destructor runs under the Windows loader
+// lock at DLL unload and can deadlock. Hosts stop the workers with atmos_shutdown instead.
+static PoolState* s_pool = new PoolState();
+static std::atomic<int32_t> s_poolSize(0);
+static std::atomic<int32_t> s_poolRequested(0);
+static std::atomic<int32_t> s_poolInFlight(0);
+
+static void pool_unlink(PoolJob* job)
+{
+    PoolJob** link = &s_pool->jobs;
+    while (*link)
+    {
+        if (*link == job)
+        {
+            *link = job->nextJob;
+            return;
+        }
+        link = &(*link)->nextJob;
+    }
+}
+
+static bool pool_claim(PoolJob* job, int32_t* begin, int32_t* end)
+{
+    if (job->next >= job->count)
+        return false;
+
+    *begin = job->next;
+    *end = job->next + job->grain;
+    if (*end > job->count)
+        *end = job->count;
+    job->next = *end;
+
+    if (job->next >= job->count)
+        pool_unlink(job);
+
+    return true;
+}
+
+static bool pool_claim_any(PoolJob** outJob, int32_t* begin, int32_t* end)
+{
+    for (PoolJob* job = s_pool->jobs; job; job = job->nextJob)
+    {
+        if (pool_claim(job, begin, end))
+        {
+            *outJob = job;
+            return true;
+        }
+    }
+    return false;
+}
+
+static void pool_run_chunk(PoolJob* job, int32_t begin, int32_t end)
+{
+    job->fn(job->context, begin, end);
+
+    if (job->remaining.fetch_sub(end - begin) == end - begin)
+    {
+        std::lock_guard<std::mutex> lock(s_pool->mutex);
+        s_pool->done.notify_all();
+    }
+}
+
+static void pool_worker_main()
+{
+    std::unique_lock<std::mutex> lock(s_pool->mutex);
+
+    for (;;)
+    {
+        PoolJob* job = nullptr;
+        int32_t begin = 0;
+        int32_t end = 0;
+
+        if (pool_claim_any(&job, &begin, &end))
+        {
+            lock.unlock();
+            pool_run_chunk(job, begin, end);
+            lock.lock();
+            continue;
+        }
+
+        if (s_pool->stop)
+            return;
+
+        s_pool->wake.wait(lock);
+    }
+}
+
+static void pool_stop_workers()
+{
+    {
+        std::lock_guard<std::mutex> lock(s_pool->mutex);
+        s_pool->stop = true;
+    }
+    s_pool->wake.notify_all();
+
+    for (size_t i = 0; i < s_pool->workers.size(); i++)
+        s_pool->workers[i].join();
+
+    s_pool->workers.clear();
+    s_pool->stop = false;
+    s_poolSize.store(0);
+}
+
+static int32_t resolve_pool_size(int32_t threads)
+{
+    if (threads > 0)
+        return threads;
+
+    threads = (int32_t)std::thread::hardware_concurrency();
+    return threads > 0 ? threads : 1;
+}
+
+static void pool_start_workers(int32_t threads)
+{
+    for (int32_t i = 1; i < threads; i++)
+        s_pool->workers.emplace_back(pool_worker_main);
+
+    s_poolSize.store(threads);
+}
+
+// Starts the pool at the configured size the first time work arrives, and again after
+// thread_pool_stop.
+static void pool_ensure_started()
+{
+    if (s_poolSize.load() > 0)
+        return;
+
+    std::lock_guard<std::mutex> resizeLock(s_pool->resizeMutex);
+    if (s_poolSize.load() == 0)
+        pool_start_workers(resolve_pool_size(s_poolRequested.load()));
+}
+
+bool thread_pool_set_size(int32_t threads)
+{
+    std::lock_guard<std::mutex> resizeLock(s_pool->resizeMutex);
+
+    int32_t size = resolve_pool_size(threads);
+    if (size != s_poolSize.load())
+    {
+        if (s_poolInFlight.load() > 0)
+            return false;
+
+        pool_stop_workers();
+        pool_start_workers(size);
+    }
+
+    s_poolRequested.store(threads > 0 ? threads : 0);
+    return true;
+}
+
+int32_t thread_pool_get_size()
+{
+    int32_t size = s_poolSize.load();
+    return size > 0 ? size : resolve_pool_size(s_poolRequested.load());
+}
+
+bool thread_pool_busy()
+{
+    return s_poolInFlight.load() > 0;
+}
+
+void thread_pool_stop()
+{
+    std::lock_guard<std::mutex> resizeLock(s_pool->resizeMutex);
+    pool_stop_workers();
+}
+
+void thread_pool_parallel_for(int32_t count, int32_t grain, AtmosJobFn fn, void* context)
+{
+    if (count <= 0)
+        return;
+
+    if (grain < 1)
+        grain = 1;
+
+    pool_ensure_started();
+
+    if (s_poolSize.load() <= 1 || count <= grain)
+    {
+        fn(context, 0, count);
+        return;
+    }
+
+    PoolJob job;
+    job.fn = fn;
+    job.context = context;
+    job.count = count;
+    job.grain = grain;
+    job.next = 0;
+    job.remaining.store(count);
+
+    s_poolInFlight.fetch_add(1);
+
+    std::unique_lock<std::mutex> lock(s_pool->mutex);
+    job.nextJob = s_pool->jobs;
+    s_pool->jobs = &job;
+    s_pool->wake.notify_all();
+
+    for (;;)
+    {
+        PoolJob* claimed = nullptr;
+        int32_t begin = 0;
+        int32_t end = 0;
+
+        if (pool_claim(&job, &begin, &end))
+            claimed = &job;
+        else if (job.remaining.load() > 0 && !pool_claim_any(&claimed, &begin, &end))
+            claimed = nullptr;
+
+        if (claimed)
+        {
+            lock.unlock();
+            pool_run_chunk(claimed, begin, end);
+            lock.lock();
+            continue;
+        }
+
+        if (job.remaining.load() == 0)
+            break;
+
+        s_pool->done.wait(lock);
+    }
+
+    s_poolInFlight.fetch_sub(1);
+}
@@ -0,0 +1,326 @@
+#include "atmos_internal.h"
+#include <chrono>
+
+#ifdef ATMOS_PHASE_TIMING
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+int64_t atmos_time_us()
+{
+    auto now = std::chrono::high_resolution_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::microseconds>(now).count();
+}
+
+static int64_t steady_ns()
+{
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+}
+
+uint64_t stats_clock()
+{
+#ifdef ATMOS_PHASE_TIMING
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+static const uint64_t s_calibrationTicks = stats_clock();
+static const int64_t s_calibrationNs = steady_ns();
+
+int64_t stats_clock_to_ns(uint64_t ticks)
+{
+    uint64_t elapsedTicks = stats_clock() - s_calibrationTicks;
+    int64_t elapsedNs = steady_ns() - s_calibrationNs;
+
+    if (elapsedTicks == 0 || elapsedNs <= 0)
+        return 0;
+
+    return (int64_t)((double)ticks * (double)elapsedNs / (double)elapsedTicks);
+}
+
+void budget_start(AtmosBudget* budget, int64_t microseconds)
+{
+    budget->deadline = atmos_time_us() + microseconds;
+    budget->sinceCheck = 0;
+}
+
+bool budget_expired(AtmosBudget* budget)
+{
+    if (!budget)
+        return false;
+
+    if (++budget->sinceCheck < ATMOS_BUDGET_CHECK_INTERVAL)
+        return false;
+
+    budget->sinceCheck = 0;
+    return atmos_time_us() > budget->deadline;
+}
+
+bool budget_expired_now(AtmosBudget* budget)
+{
+    if (!budget)
+        return false;
+
+    budget->sinceCheck = 0;
+    return atmos_time_us() > budget->deadline;
+}
+
+bool run_archive_phase(GridAtmosState* state, int32_t* cursor, AtmosBudget* budget)
+{
+    if (*cursor == 0)
+        begin_archive_epoch(state);
+
+    int32_t total = state->activeTileCount + state->superconductTileCount;
+
+    for (int32_t i = *cursor; i < total; i++)
+    {
+        int32_t tileIndex = i < state->activeTileCount
+            ? state->activeTiles[i]
+            : state->superconductTiles[i - state->activeTileCount];
+
+        if (tileIndex >= 0 && tileIndex < state->tileCount)
+            archive_tile_and_neighbors(state, tileIndex);
+
+        if (budget_expired(budget))
+        {
+            *cursor = i + 1;
+            return false;
+        }
+    }
+
+    *cursor = 0;
+    return true;
+}
+
+bool run_active_phase(GridAtmosState* state, const AtmosConfig* config, int32_t* cursor, AtmosBudget* budget, AtmosResult* result)
+{
+    if (config->parallelLindaEnabled)
+    {
+        bool complete = true;
+        result->tilesProcessed += process_active_tiles_batched(state, config, budget, *cursor > 0, &complete);
+        *cursor = complete ? 0 : 1;
+        return complete;
+    }
+
+    for (int32_t i = *cursor; i < state->activeTileCount; i++)
+    {
+        int32_t tileIndex = state->activeTiles[i];
+        if (tileIndex < 0 || tileIndex >= state->tileCount)
+            continue;
+
+        archive_tile_and_neighbors(state, tileIndex);
+
+        if (config->monstermosEnabled)
+        {
+            equalize_pressure_in_zone(state, tileIndex, config);
+        }
+
+        process_cell(state, tileIndex, config);
+        result->tilesProcessed++;
+
+        if (budget_expired(budget))
+        {
+            *cursor = i + 1;
+            return false;
+        }
+    }
+
+    *cursor = 0;
+    return true;
+}
+
+bool run_excited_groups_phase(GridAtmosState* state, const AtmosConfig* config, int32_t* cursor, AtmosBudget* budget)
+{
+    for (int32_t i = *cursor; i < state->excitedGroupCount; i++)
+    {
+        ExcitedGroupData* group = &state->excitedGroups[i];
+        if (group->disposed || group->parent != i) continue;
+
+        group->breakdownCooldown++;
+        group->dismantleCooldown++;
+
+        if (group->peakShare <= config->constants.minimumMolesDeltaToMove &&
+            group->peakTemperatureDelta <= config->constants.minimumTemperatureDeltaToSuspend)
+            group->calmCycles++;
+        else
+            group->calmCycles = 0;
+
+        group->peakShare = 0.0f;
+        group->peakTemperatureDelta = 0.0f;
+
+        if (group->breakdownCooldown > config->constants.excitedGroupBreakdownCycles)
+        {
+            excited_group_self_breakdown(state, i, config);
+            state->stats.groupBreakdowns++;
+        }
+        else if (group->dismantleCooldown > config->constants.excitedGroupsDismantleCycles)
+        {
+            deactivate_group_tiles(state, i);
+            state->stats.groupDismantles++;
+        }
+        else if (group->calmCycles >= config->constants.excitedGroupSleepCycles)
+        {
+            sleep_excited_group(state, i);
+        }
+
+        if (budget_expired(budget))
+        {
+            *cursor = i + 1;
+            return false;
+        }
+    }
+
+    *cursor = 0;
+    return true;
+}
+
+bool run_hotspot_phase(GridAtmosState* state, const AtmosConfig* config, int32_t* cursor, AtmosBudget* budget)
+{
+    for (int32_t i = *cursor; i < state->hotspotTileCount; i++)
+    {
+        process_hotspot(state, state->hotspotTiles[i], config);
+        state->stats.hotspotsProcessed++;
+
+        if (budget_expired(budget))
+        {
+            *cursor = i + 1;
+            return false;
+        }
+    }
+
+    *cursor = 0;
+    return true;
+}
+
+bool run_superconduct_phase(GridAtmosState* state, const AtmosConfig* config, int32_t* cursor, AtmosBudget* budget)
+{
+    for (int32_t i = *cursor; i < state->superconductTileCount; i++)
+    {
+        superconduct(state, state->superconductTiles[i], config);
+        state->stats.superconductTilesProcessed++;
+
+        if (budget_expired(budget))
+        {
+            *cursor = i + 1;
+            return false;
+        }
+    }
+
+    *cursor = 0;
+    return true;
+}
+
+bool run_high_pressure_phase(GridAtmosState* state, const AtmosConfig* config, int32_t* cursor, AtmosBudget* budget, AtmosResult* result)
+{
+    if (*cursor == 0)
+        state->windEventCount = 0;
+
+    for (int32_t i = *cursor; i < state->highPressureTileCount; i++)
+    {
+        int32_t tileIndex = state->highPressureTiles[i];
+        TileAtmosData* tile = &state->tiles[tileIndex];
+
+        high_pressure_movements(state, tileIndex, config);
+
+        if (tile->pressureDifference > result->maxPressureDelta)
+            result->maxPressureDelta = tile->pressureDifference;
+
+        tile->pressureDifference = 0.0f;
+        tile->currentTransferDirection = -1;
+
+        if (budget_expired(budget))
+        {
+            *cursor = i + 1;
+            return false;
+        }
+    }
+
+    state->highPressureTileCount = 0;
+    *cursor = 0;
+    return true;
+}
+
+static bool run_phase(GridAtmosState* state, const AtmosConfig* config, AtmosBudget* budget, AtmosResult* result)
+{
+    int32_t* cursor = &state->processCursor;
+
+    switch (state->processPhase)
+    {
+        case ATMOS_PHASE_ARCHIVE:
+            return run_archive_phase(state, cursor, budget);
+        case ATMOS_PHASE_ACTIVE:
+            return run_active_phase(state, config, cursor, budget, result);
+        case ATMOS_PHASE_EXCITED_GROUPS:
+            return !config->excitedGroupsEnabled || run_excited_groups_phase(state, config, cursor, budget);
+        case ATMOS_PHASE_HOTSPOTS:
+            return run_hotspot_phase(state, config, cursor, budget);
+        case ATMOS_PHASE_SUPERCONDUCT:
+            return !config->superconductionEnabled || run_superconduct_phase(state, config, cursor, budget);
+        case ATMOS_PHASE_HIGH_PRESSURE:
+            return run_high_pressure_phase(state, config, cursor, budget, result);
+    }
+
+    return true;
+}
+
+AtmosResult process_tick(GridAtmosState* state, const AtmosConfig* config)
+{
+    AtmosResult result = {};
+
+    AtmosBudget budget;
+    budget_start(&budget, config->maxProcessTimeMicroseconds);
+
+    if (state->processPhase < 0 || state->processPhase >= ATMOS_PHASE_COUNT)
+    {
+        state->processPhase = ATMOS_PHASE_ARCHIVE;
+        state->processCursor = 0;
+    }
+
+    if (state->processPhase == ATMOS_PHASE_ARCHIVE && state->processCursor == 0)
+        state->updateCounter++;
+
+    int32_t reactionsBefore = state->stats.reactionsTriggered;
+
+    bool complete = true;
+    while (state->processPhase < ATMOS_PHASE_COUNT)
+    {
+        uint64_t phaseStart = stats_clock();
+        bool phaseComplete = run_phase(state, config, &budget, &result);
+        state->phaseTicks[state->processPhase] += stats_clock() - phaseStart;
+
+        if (!phaseComplete)
+        {
+            complete = false;
+            break;
+        }
+
+        state->processPhase++;
+        state->processCursor = 0;
+    }
+
+    if (complete)
+    {
+        state->processPhase = ATMOS_PHASE_ARCHIVE;
+        state->stats.ticks++;
+    }
+
+    state->stats.tilesProcessed += result.tilesProcessed;
+    result.reactionsTriggered = state->stats.reactionsTriggered - reactionsBefore;
+
+    if (config->excitedGroupsEnabled)
+        result.excitedGroupsCount = state->excitedGroupCount;
+    if (config->superconductionEnabled)
+        result.superconductTilesCount = state->superconductTileCount;
+
+    result.hotspotTilesCount = state->hotspotTileCount;
+    result.activeTilesCount = state->activeTileCount;
+    result.processingComplete = complete ? 1 : 0;
+
+    return result;
+}
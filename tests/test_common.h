@@ -164,4 +164,18 @@ public:
 
 private:
     std::chrono::high_resolution_clock::time_point startTime;
-};
\ No newline at end of file
+};
+// Sizes the shared worker pool for one test and restores the previous size afterwards.
+class ScopedWorkerThreads {
+public:
+    explicit ScopedWorkerThreads(int32_t threads) : previous(atmos_get_worker_threads()) {
+        atmos_set_worker_threads(threads);
+    }
+
+    ~ScopedWorkerThreads() {
+        atmos_set_worker_threads(previous);
+    }
+
+private:
+    int32_t previous;
+};
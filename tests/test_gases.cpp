@@ -1,4 +1,5 @@
 #include "test_common.h"
+#include <vector>
 
 class GasesTest : public AtmosTestFixture {};
 
@@ -302,4 +303,139 @@ TEST_F(GasesTest, CompareExchangeTemperatureDelta) {
     
     int result = compare_exchange(&a, &b, &config);
     EXPECT_EQ(result, -1);
-}
\ No newline at end of file
+}
+TEST_F(GasesTest, ActiveSetSwapRemoveKeepsSlots) {
+    const int count = 600;
+    for (int i = 0; i < count; i++) {
+        TileAtmosData tile = CreateStandardTile(i, 0);
+        atmos_add_tile(state, &tile);
+    }
+
+    for (int i = 0; i < count; i++)
+        atmos_add_active_tile(state, i);
+    atmos_add_active_tile(state, 5);
+    EXPECT_EQ(state->activeTileCount, count);
+
+    for (int i = 0; i < count; i += 2)
+        atmos_remove_active_tile(state, i);
+    EXPECT_EQ(state->activeTileCount, count / 2);
+
+    for (int i = 0; i < state->activeTileCount; i++) {
+        int32_t tileIndex = state->activeTiles[i];
+        EXPECT_EQ(tileIndex % 2, 1);
+        EXPECT_EQ(state->activeSlots[tileIndex], i);
+    }
+}
+
+TEST_F(GasesTest, TileSetRemoveRejectsNonMembers) {
+    for (int i = 0; i < 4; i++) {
+        TileAtmosData tile = CreateStandardTile(i, 0);
+        atmos_add_tile(state, &tile);
+    }
+    for (int i = 0; i < 3; i++)
+        tile_set_insert(&state->highPressureTiles, &state->highPressureTileCount, &state->highPressureTileCapacity, state->highPressureSlots, i);
+
+    EXPECT_FALSE(tile_set_remove(state->highPressureTiles, &state->highPressureTileCount, state->highPressureSlots, 3));
+    EXPECT_EQ(state->highPressureTileCount, 3);
+
+    EXPECT_TRUE(tile_set_remove(state->highPressureTiles, &state->highPressureTileCount, state->highPressureSlots, 0));
+    EXPECT_EQ(state->highPressureTileCount, 2);
+    EXPECT_EQ(state->highPressureSlots[2], 0);
+    EXPECT_FALSE(tile_set_remove(state->highPressureTiles, &state->highPressureTileCount, state->highPressureSlots, 0));
+}
+
+TEST_F(GasesTest, HighPressureEmitsWindEvents) {
+    for (int i = 0; i < 4; i++) {
+        TileAtmosData tile = CreateStandardTile(i, 0);
+        atmos_add_tile(state, &tile);
+    }
+
+    consider_pressure_difference(state, 2, ATMOS_DIR_EAST, -50.0f);
+    consider_pressure_difference(state, 2, ATMOS_DIR_WEST, 20.0f);
+
+    atmos_process_high_pressure(state, &config);
+
+    const AtmosWindEvent* events = nullptr;
+    ASSERT_EQ(atmos_get_wind_events(state, &events), 1);
+    EXPECT_EQ(events[0].tileIndex, 2);
+    EXPECT_EQ(events[0].direction, ATMOS_DIR_EAST);
+    EXPECT_FLOAT_EQ(events[0].pressureDifference, 50.0f);
+    EXPECT_FLOAT_EQ(state->tiles[2].pressureDifference, 0.0f);
+
+    atmos_process_high_pressure(state, &config);
+    EXPECT_EQ(atmos_get_wind_events(state, &events), 0);
+}
+
+TEST_F(GasesTest, ExcitedGroupMergesShareRootAndRecycleSlots) {
+    for (int i = 0; i < 16; i++) {
+        TileAtmosData tile = CreateStandardTile(i, 0);
+        atmos_add_tile(state, &tile);
+    }
+
+    int32_t groups[4];
+    for (int g = 0; g < 4; g++) {
+        groups[g] = create_excited_group(state);
+        for (int t = 0; t < 4; t++)
+            add_tile_to_excited_group(state, groups[g], g * 4 + t);
+    }
+
+    merge_excited_groups(state, groups[0], groups[1]);
+    merge_excited_groups(state, groups[2], groups[3]);
+    merge_excited_groups(state, groups[1], groups[3]);
+
+    int32_t root = resolve_excited_group(state, groups[0]);
+    ASSERT_GE(root, 0);
+    EXPECT_EQ(state->excitedGroups[root].tileCount, 16);
+
+    int visited = 0;
+    for (int32_t t = state->excitedGroups[root].firstTile; t >= 0; t = state->groupTileNext[t]) {
+        EXPECT_EQ(resolve_excited_group(state, state->tiles[t].excitedGroupId), root);
+        visited++;
+    }
+    EXPECT_EQ(visited, 16);
+
+    remove_tile_from_excited_group(state, state->tiles[5].excitedGroupId, 5);
+    EXPECT_EQ(state->tiles[5].excitedGroupId, -1);
+    EXPECT_EQ(state->excitedGroups[root].tileCount, 15);
+
+    dispose_excited_group(state, groups[3]);
+    for (int i = 0; i < 16; i++)
+        EXPECT_EQ(state->tiles[i].excitedGroupId, -1);
+
+    int32_t countBefore = state->excitedGroupCount;
+    for (int g = 0; g < 4; g++)
+        EXPECT_LT(create_excited_group(state), countBefore);
+    EXPECT_EQ(state->excitedGroupCount, countBefore);
+}
+
+TEST_F(GasesTest, BatchQueryMatchesPerTileQueries) {
+    SetupLinearGrid(10);
+    TileAtmosData space = CreateSpaceTile(10, 0);
+    atmos_add_tile(state, &space);
+
+    for (int i = 0; i < 10; i++) {
+        state->tiles[i].moles[GAS_PLASMA] = 3.0f * i;
+        state->tiles[i].temperature = 200.0f + 40.0f * i;
+    }
+
+    int32_t count = state->tileCount;
+    std::vector<float> heatCapacity(count), pressure(count), totalMoles(count), thermalEnergy(count);
+    EXPECT_EQ(atmos_query_grid(state, &config, heatCapacity.data(), pressure.data(), totalMoles.data(), thermalEnergy.data()), count);
+
+    for (int i = 0; i < count; i++) {
+        const TileAtmosData* tile = &state->tiles[i];
+        EXPECT_NEAR(heatCapacity[i], atmos_get_heat_capacity(tile, config.gasSpecificHeats), heatCapacity[i] * 1e-5f);
+        EXPECT_NEAR(thermalEnergy[i], atmos_get_thermal_energy(tile, config.gasSpecificHeats), thermalEnergy[i] * 1e-5f);
+        EXPECT_NEAR(totalMoles[i], GetTotalMoles(tile), 1e-3f);
+        EXPECT_NEAR(pressure[i], tile_pressure(tile, config.constants.R, config.constants.cellVolume), pressure[i] * 1e-5f + 1e-6f);
+    }
+
+    int32_t indices[3] = { 7, 10, 2 };
+    float picked[3];
+    EXPECT_EQ(atmos_query_tiles(state, indices, 3, &config, picked, nullptr, nullptr, nullptr), 3);
+    for (int i = 0; i < 3; i++)
+        EXPECT_FLOAT_EQ(picked[i], heatCapacity[indices[i]]);
+
+    int32_t invalid[2] = { 1, count };
+    EXPECT_EQ(atmos_query_tiles(state, invalid, 2, &config, picked, nullptr, nullptr, nullptr), 0);
+}
@@ -1,4 +1,7 @@
 #include "test_common.h"
+#include <atomic>
+#include <thread>
+#include <vector>
 
 class IntegrationTest : public AtmosTestFixture {
 protected:
@@ -314,4 +317,475 @@ TEST_F(IntegrationTest, StabilityTest) {
             }
         }
     }
-}
\ No newline at end of file
+}
+TEST_F(IntegrationTest, ProcessManyMatchesSerialProcess) {
+    const int gridCount = 6;
+    int sizes[gridCount] = { 4, 40, 6, 24, 3, 12 };
+
+    auto buildGrid = [&](int width, int seed) {
+        GridAtmosState* grid = atmos_create_grid(width * width);
+        for (int y = 0; y < width; y++) {
+            for (int x = 0; x < width; x++) {
+                TileAtmosData tile = CreateStandardTile(x, y);
+                tile.moles[GAS_OXYGEN] = 10.0f + (float)((x * 7 + y * 13 + seed) % 90);
+                atmos_add_tile(grid, &tile);
+            }
+        }
+        for (int y = 0; y < width; y++) {
+            for (int x = 0; x < width; x++) {
+                int idx = y * width + x;
+                if (x < width - 1) {
+                    atmos_set_adjacency(grid, idx, ATMOS_DIR_EAST, idx + 1);
+                    atmos_set_adjacency(grid, idx + 1, ATMOS_DIR_WEST, idx);
+                }
+                if (y < width - 1) {
+                    atmos_set_adjacency(grid, idx, ATMOS_DIR_SOUTH, idx + width);
+                    atmos_set_adjacency(grid, idx + width, ATMOS_DIR_NORTH, idx);
+                }
+            }
+        }
+        for (int i = 0; i < width * width; i += 2)
+            atmos_add_active_tile(grid, i);
+        return grid;
+    };
+
+    ScopedWorkerThreads workers(4);
+
+    AtmosConfig manyConfig = config;
+    manyConfig.parallelLindaEnabled = 1;
+    manyConfig.maxProcessTimeMicroseconds = 1000000;
+
+    GridAtmosState* serial[gridCount];
+    GridAtmosState* batched[gridCount + 1];
+    for (int g = 0; g < gridCount; g++) {
+        serial[g] = buildGrid(sizes[g], g);
+        batched[g] = buildGrid(sizes[g], g);
+    }
+    batched[gridCount] = nullptr;
+
+    AtmosResult results[gridCount + 1];
+    for (int cycle = 0; cycle < 5; cycle++) {
+        atmos_process_many(batched, gridCount + 1, &manyConfig, results);
+        for (int g = 0; g < gridCount; g++) {
+            AtmosResult expected = atmos_process(serial[g], &manyConfig);
+            EXPECT_EQ(results[g].activeTilesCount, expected.activeTilesCount);
+            EXPECT_EQ(results[g].processingComplete, expected.processingComplete);
+        }
+        EXPECT_EQ(results[gridCount].tilesProcessed, 0);
+    }
+
+    for (int g = 0; g < gridCount; g++) {
+        for (int i = 0; i < serial[g]->tileCount; i++) {
+            for (int gas = 0; gas < ATMOS_GAS_COUNT; gas++)
+                ASSERT_EQ(batched[g]->tiles[i].moles[gas], serial[g]->tiles[i].moles[gas]);
+            ASSERT_EQ(batched[g]->tiles[i].temperature, serial[g]->tiles[i].temperature);
+        }
+        atmos_destroy_grid(serial[g]);
+        atmos_destroy_grid(batched[g]);
+    }
+}
+
+TEST_F(IntegrationTest, ProcessManyTicksRepeatedGridOnce) {
+    SetupSquareGrid(8, 8);
+    ScopedWorkerThreads workers(4);
+    for (int i = 0; i < 64; i++) {
+        state->tiles[i].moles[GAS_OXYGEN] = 10.0f + (float)(i % 5) * 20.0f;
+        atmos_add_active_tile(state, i);
+    }
+
+    GridAtmosState* grids[3] = { state, state, state };
+    AtmosResult results[3];
+    int32_t counterBefore = state->updateCounter;
+
+    atmos_process_many(grids, 3, &config, results);
+
+    EXPECT_EQ(state->updateCounter, counterBefore + 1);
+    EXPECT_GT(results[0].tilesProcessed, 0);
+    EXPECT_EQ(results[1].tilesProcessed, results[0].tilesProcessed);
+    EXPECT_EQ(results[2].activeTilesCount, results[0].activeTilesCount);
+}
+
+static void resize_pool_job(void* context, int32_t begin, int32_t end) {
+    std::atomic<int32_t>* accepted = (std::atomic<int32_t>*)context;
+    for (int32_t i = begin; i < end; i++)
+        *accepted += atmos_set_worker_threads(3);
+}
+
+TEST_F(IntegrationTest, WorkerResizeRejectedWhilePoolBusy) {
+    ScopedWorkerThreads workers(2);
+
+    std::atomic<int32_t> accepted(0);
+    thread_pool_parallel_for(8, 1, resize_pool_job, &accepted);
+
+    EXPECT_EQ(accepted.load(), 0);
+    EXPECT_EQ(atmos_get_worker_threads(), 2);
+    EXPECT_EQ(atmos_set_worker_threads(3), 1);
+    EXPECT_EQ(atmos_get_worker_threads(), 3);
+}
+
+TEST_F(IntegrationTest, ShutdownKeepsConfiguredWorkerCount) {
+    ScopedWorkerThreads workers(4);
+    SetupSquareGrid(8, 8);
+    for (int i = 0; i < 64; i++)
+        atmos_add_active_tile(state, i);
+
+    atmos_shutdown();
+    EXPECT_EQ(atmos_get_worker_threads(), 4);
+
+    GridAtmosState* grids[1] = { state };
+    AtmosResult results[1];
+    atmos_process_many(grids, 1, &config, results);
+    EXPECT_GT(results[0].tilesProcessed, 0);
+    EXPECT_EQ(atmos_get_worker_threads(), 4);
+}
+
+TEST_F(IntegrationTest, DefaultWorkerCountUsesEveryHardwareThread) {
+    ScopedWorkerThreads workers(0);
+
+    int32_t hardware = (int32_t)std::thread::hardware_concurrency();
+    EXPECT_EQ(atmos_get_worker_threads(), hardware > 0 ? hardware : 1);
+
+    atmos_shutdown();
+    EXPECT_EQ(atmos_get_worker_threads(), hardware > 0 ? hardware : 1);
+}
+
+TEST_F(IntegrationTest, BudgetedTickResumesAcrossCalls) {
+    SetupSquareGrid(30, 30);
+    config.monstermosEnabled = 0;
+    config.maxProcessTimeMicroseconds = 0;
+
+    for (int i = 0; i < 900; i++) {
+        state->tiles[i].moles[GAS_OXYGEN] = 10.0f + (float)(i % 17) * 5.0f;
+        atmos_add_active_tile(state, i);
+    }
+
+    int32_t counterBefore = state->updateCounter;
+    int calls = 0;
+    int tilesProcessed = 0;
+    AtmosResult result = {};
+
+    do {
+        result = atmos_process(state, &config);
+        tilesProcessed += result.tilesProcessed;
+        calls++;
+        EXPECT_EQ(state->updateCounter, counterBefore + 1);
+    } while (!result.processingComplete && calls < 10000);
+
+    EXPECT_EQ(result.processingComplete, 1);
+    EXPECT_GT(calls, 1);
+    EXPECT_GE(tilesProcessed, 900);
+    EXPECT_EQ(state->processPhase, ATMOS_PHASE_ARCHIVE);
+    EXPECT_EQ(state->tiles[899].lastCycle, state->updateCounter);
+
+    atmos_process(state, &config);
+    EXPECT_EQ(state->updateCounter, counterBefore + 2);
+}
+
+TEST_F(IntegrationTest, BudgetedBatchedTickProcessesEveryActiveTile) {
+    SetupSquareGrid(30, 30);
+    config.monstermosEnabled = 0;
+    config.excitedGroupsEnabled = 0;
+    config.parallelLindaEnabled = 1;
+    ScopedWorkerThreads workers(2);
+    config.maxProcessTimeMicroseconds = 0;
+
+    for (int i = 0; i < 900; i++) {
+        state->tiles[i].moles[GAS_OXYGEN] = 10.0f + (float)(i % 17) * 5.0f;
+        atmos_add_active_tile(state, i);
+    }
+
+    int calls = 0;
+    AtmosResult result = {};
+    do {
+        result = atmos_process(state, &config);
+        calls++;
+    } while (!result.processingComplete && calls < 10000);
+
+    EXPECT_EQ(result.processingComplete, 1);
+    EXPECT_GT(calls, 1);
+    for (int i = 0; i < 900; i++)
+        ASSERT_EQ(state->tiles[i].lastCycle, state->updateCounter);
+}
+
+TEST_F(IntegrationTest, BudgetedBatchedTickResumesInsideMonstermos) {
+    SetupSquareGrid(30, 30);
+    config.parallelLindaEnabled = 1;
+    config.maxProcessTimeMicroseconds = 0;
+
+    for (int i = 0; i < 900; i++) {
+        state->tiles[i].moles[GAS_OXYGEN] = 10.0f + (float)(i % 17) * 5.0f;
+        atmos_add_active_tile(state, i);
+    }
+
+    int calls = 0;
+    int tilesProcessed = 0;
+    bool pausedInMonstermos = false;
+    AtmosResult result = {};
+    do {
+        result = atmos_process(state, &config);
+        tilesProcessed += result.tilesProcessed;
+        calls++;
+
+        const LindaPassScratch* scratch = state->lindaScratch;
+        if (!result.processingComplete && state->processPhase == ATMOS_PHASE_ACTIVE && scratch &&
+            scratch->monstermosCursor > scratch->colorStart[0] && scratch->monstermosCursor < scratch->colorStart[1])
+            pausedInMonstermos = true;
+    } while (!result.processingComplete && calls < 10000);
+
+    EXPECT_EQ(result.processingComplete, 1);
+    EXPECT_TRUE(pausedInMonstermos);
+    EXPECT_EQ(tilesProcessed, 900);
+}
+
+TEST_F(IntegrationTest, ArchiveTouchesOnlyActiveTilesAndNeighbors) {
+    SetupSquareGrid(30, 30);
+    config.monstermosEnabled = 0;
+
+    state->tiles[0].moles[GAS_OXYGEN] = 200.0f;
+    state->tiles[899].molesArchived[GAS_OXYGEN] = -1.0f;
+    atmos_add_active_tile(state, 0);
+
+    atmos_process(state, &config);
+
+    EXPECT_FLOAT_EQ(state->tiles[1].molesArchived[GAS_OXYGEN], 21.0f);
+    EXPECT_FLOAT_EQ(state->tiles[30].molesArchived[GAS_OXYGEN], 21.0f);
+    EXPECT_FLOAT_EQ(state->tiles[0].molesArchived[GAS_OXYGEN], 200.0f);
+    EXPECT_FLOAT_EQ(state->tiles[899].molesArchived[GAS_OXYGEN], -1.0f);
+}
+
+TEST_F(IntegrationTest, MonstermosArchivesZoneBeforeEqualizing) {
+    SetupSquareGrid(10, 10);
+    config.monstermosEnabled = 1;
+
+    state->tiles[0].moles[GAS_OXYGEN] = 200.0f;
+    state->tiles[55].molesArchived[GAS_OXYGEN] = -1.0f;
+    atmos_add_active_tile(state, 0);
+
+    atmos_process(state, &config);
+
+    EXPECT_GT(state->tiles[55].moles[GAS_OXYGEN], 21.0f);
+    EXPECT_FLOAT_EQ(state->tiles[55].molesArchived[GAS_OXYGEN], 21.0f);
+    EXPECT_FLOAT_EQ(state->tiles[0].molesArchived[GAS_OXYGEN], 200.0f);
+}
+
+TEST_F(IntegrationTest, StatsTrackReactionsAndPhases) {
+    SetupLinearGrid(5);
+
+    for (int i = 0; i < 5; i++) {
+        state->tiles[i].moles[GAS_OXYGEN] = 30.0f;
+        state->tiles[i].moles[GAS_NITROGEN] = 0.0f;
+        state->tiles[i].moles[GAS_PLASMA] = 20.0f;
+        state->tiles[i].temperature = config.constants.plasmaMinimumBurnTemperature + 50.0f;
+        atmos_add_active_tile(state, i);
+    }
+
+    int32_t reactions = 0;
+    for (int cycle = 0; cycle < 10; cycle++)
+        reactions += atmos_process(state, &config).reactionsTriggered;
+
+    AtmosStats stats;
+    atmos_get_stats(state, &stats, 1);
+
+    EXPECT_EQ(stats.ticks, 10);
+    EXPECT_GT(reactions, 0);
+    EXPECT_EQ(stats.reactionsTriggered, reactions);
+    EXPECT_GT(stats.reactionCounts[ATMOS_REACTION_PLASMA_FIRE], 0);
+    EXPECT_GT(stats.tilesProcessed, 0);
+    EXPECT_GE(stats.totalNanoseconds, stats.phaseNanoseconds[ATMOS_PHASE_ACTIVE]);
+
+    atmos_get_stats(state, &stats, 0);
+    EXPECT_EQ(stats.ticks, 0);
+    EXPECT_EQ(stats.reactionsTriggered, 0);
+    EXPECT_EQ(stats.totalNanoseconds, 0);
+}
+
+TEST_F(IntegrationTest, SettledExcitedGroupSleepsAndWakes) {
+    SetupLinearGrid(4);
+    config.monstermosEnabled = 0;
+
+    int32_t groupId = create_excited_group(state);
+    for (int i = 0; i < 4; i++) {
+        atmos_add_active_tile(state, i);
+        add_tile_to_excited_group(state, groupId, i);
+    }
+
+    for (int cycle = 0; cycle < 8; cycle++)
+        atmos_process(state, &config);
+
+    int32_t root = resolve_excited_group(state, state->tiles[0].excitedGroupId);
+    ASSERT_GE(root, 0);
+    EXPECT_EQ(state->excitedGroups[root].sleeping, 1);
+    EXPECT_EQ(state->excitedGroups[root].tileCount, 4);
+    EXPECT_EQ(state->activeTileCount, 0);
+
+    TileAtmosData tile = state->tiles[2];
+    tile.moles[GAS_OXYGEN] += 50.0f;
+    atmos_update_tile(state, 2, &tile);
+
+    EXPECT_EQ(state->excitedGroups[root].sleeping, 0);
+    EXPECT_EQ(state->activeTileCount, 4);
+
+    AtmosStats stats;
+    atmos_get_stats(state, &stats, 0);
+    EXPECT_EQ(stats.groupSleeps, 1);
+    EXPECT_EQ(stats.groupWakes, 1);
+}
+
+TEST_F(IntegrationTest, SleepingExcitedGroupIsStillDismantled) {
+    SetupLinearGrid(4);
+    config.monstermosEnabled = 0;
+
+    int32_t groupId = create_excited_group(state);
+    for (int i = 0; i < 4; i++) {
+        atmos_add_active_tile(state, i);
+        add_tile_to_excited_group(state, groupId, i);
+    }
+
+    int32_t freeBefore = state->freeExcitedGroup;
+    for (int cycle = 0; cycle < config.constants.excitedGroupsDismantleCycles + 4; cycle++)
+        atmos_process(state, &config);
+
+    AtmosStats stats;
+    atmos_get_stats(state, &stats, 0);
+    EXPECT_EQ(stats.groupSleeps, 1);
+    EXPECT_GE(stats.groupBreakdowns, 1);
+    EXPECT_EQ(stats.groupDismantles, 1);
+    EXPECT_NE(state->freeExcitedGroup, freeBefore);
+    for (int i = 0; i < 4; i++)
+        EXPECT_EQ(state->tiles[i].excitedGroupId, -1);
+}
+
+TEST_F(IntegrationTest, BulkAddTilesBuildsAdjacencyFromCoordinates) {
+    const int width = 20;
+    std::vector<TileAtmosData> tiles;
+    for (int y = width - 1; y >= 0; y--)
+        for (int x = 0; x < width; x++)
+            if (x != 10)
+                tiles.push_back(CreateStandardTile(x, y));
+
+    tiles[0].blockedBits = 1 << ATMOS_DIR_EAST;
+
+    std::vector<int32_t> indices(tiles.size());
+    int32_t first = atmos_add_tiles(state, tiles.data(), (int32_t)tiles.size(), indices.data(), 1);
+    ASSERT_EQ(first, 0);
+    EXPECT_EQ(atmos_get_tile_count(state), (int32_t)tiles.size());
+
+    auto find = [&](int x, int y) {
+        for (int32_t i = 0; i < state->tileCount; i++)
+            if (state->tiles[i].gridX == x && state->tiles[i].gridY == y)
+                return i;
+        return -1;
+    };
+
+    int32_t center = find(4, 7);
+    EXPECT_EQ(state->tiles[center].adjacentIndices[ATMOS_DIR_NORTH], find(4, 8));
+    EXPECT_EQ(state->tiles[center].adjacentIndices[ATMOS_DIR_SOUTH], find(4, 6));
+    EXPECT_EQ(state->tiles[center].adjacentIndices[ATMOS_DIR_EAST], find(5, 7));
+    EXPECT_EQ(state->tiles[center].adjacentIndices[ATMOS_DIR_WEST], find(3, 7));
+    EXPECT_EQ(state->tiles[center].adjacentBits, 0x0F);
+
+    EXPECT_FALSE(state->tiles[0].adjacentBits & (1 << ATMOS_DIR_EAST));
+    EXPECT_FALSE(state->tiles[1].adjacentBits & (1 << ATMOS_DIR_WEST));
+    EXPECT_FALSE(state->tiles[find(9, 3)].adjacentBits & (1 << ATMOS_DIR_EAST));
+
+    std::vector<TileAtmosData> column;
+    for (int y = 0; y < width; y++)
+        column.push_back(CreateStandardTile(10, y));
+
+    first = atmos_add_tiles(state, column.data(), width, nullptr, 1);
+    EXPECT_EQ(state->tiles[find(9, 3)].adjacentIndices[ATMOS_DIR_EAST], first + 3);
+    EXPECT_EQ(state->tiles[find(11, 3)].adjacentIndices[ATMOS_DIR_WEST], first + 3);
+    EXPECT_EQ(state->groupTileNext[first + 3], -1);
+    EXPECT_EQ(state->groupTilePrev[first + 3], -1);
+}
+
+TEST_F(IntegrationTest, OptimizeLayoutRemapsTilesAlongMortonCurve) {
+    const int width = 16;
+    std::vector<TileAtmosData> tiles;
+    for (int chunk = 0; chunk < 4; chunk++)
+        for (int y = 0; y < width; y++)
+            for (int x = 0; x < width / 4; x++)
+                tiles.push_back(CreateStandardTile((3 - chunk) * (width / 4) + x, y));
+
+    atmos_add_tiles(state, tiles.data(), (int32_t)tiles.size(), nullptr, 1);
+    state->tiles[5].moles[GAS_OXYGEN] = 500.0f;
+    atmos_add_active_tile(state, 5);
+    atmos_process(state, &config);
+
+    std::vector<TileAtmosData> before(state->tiles, state->tiles + state->tileCount);
+    std::vector<int32_t> remap(state->tileCount);
+    TileAtmosData* tilesPtr = atmos_get_tiles_ptr(state);
+
+    ASSERT_EQ(atmos_optimize_layout(state, remap.data()), 1);
+    EXPECT_EQ(atmos_get_tiles_ptr(state), tilesPtr);
+
+    EXPECT_EQ(state->tiles[0].gridX, 0);
+    EXPECT_EQ(state->tiles[0].gridY, 0);
+    EXPECT_EQ(state->tiles[3].gridX, 1);
+    EXPECT_EQ(state->tiles[3].gridY, 1);
+
+    for (int32_t i = 0; i < state->tileCount; i++) {
+        const TileAtmosData* moved = &state->tiles[remap[i]];
+        EXPECT_EQ(moved->gridX, before[i].gridX);
+        EXPECT_EQ(moved->gridY, before[i].gridY);
+        EXPECT_FLOAT_EQ(moved->moles[GAS_OXYGEN], before[i].moles[GAS_OXYGEN]);
+
+        for (int d = 0; d < ATMOS_DIRECTIONS; d++) {
+            int32_t adj = before[i].adjacentIndices[d];
+            EXPECT_EQ(moved->adjacentIndices[d], adj >= 0 ? remap[adj] : -1);
+        }
+    }
+
+    for (int32_t i = 0; i < state->activeTileCount; i++) {
+        int32_t tileIndex = state->activeTiles[i];
+        EXPECT_TRUE(state->tiles[tileIndex].flags & TILE_FLAG_EXCITED);
+        EXPECT_EQ(state->activeSlots[tileIndex], i);
+    }
+
+    for (int32_t g = 0; g < state->excitedGroupCount; g++) {
+        const ExcitedGroupData* group = &state->excitedGroups[g];
+        if (group->disposed || group->parent != g) continue;
+        for (int32_t t = group->firstTile; t >= 0; t = state->groupTileNext[t])
+            EXPECT_EQ(resolve_excited_group(state, state->tiles[t].excitedGroupId), g);
+    }
+
+    AtmosResult result = atmos_process(state, &config);
+    EXPECT_EQ(result.processingComplete, 1);
+}
+
+TEST_F(IntegrationTest, ReservedTileStorageKeepsAddressStable) {
+    SetupLinearGrid(10);
+    uint32_t generation = atmos_get_layout_generation(state);
+
+    EXPECT_EQ(atmos_reserve_tile_storage(state, 100), 0);
+    ASSERT_EQ(atmos_reserve_tile_storage(state, 4096), 1);
+    EXPECT_NE(atmos_get_layout_generation(state), generation);
+    EXPECT_EQ(atmos_reserve_tile_storage(state, 8192), 0);
+    EXPECT_FLOAT_EQ(state->tiles[9].moles[GAS_NITROGEN], 79.0f);
+
+    TileAtmosData* tiles = atmos_get_tiles_ptr(state);
+    generation = atmos_get_layout_generation(state);
+
+    for (int i = 10; i < 4096; i++) {
+        TileAtmosData tile = CreateStandardTile(i, 0);
+        ASSERT_EQ(atmos_add_tile(state, &tile), i);
+    }
+
+    EXPECT_EQ(atmos_get_tiles_ptr(state), tiles);
+    EXPECT_EQ(atmos_get_layout_generation(state), generation);
+    EXPECT_EQ(tiles[4095].gridX, 4095);
+
+    TileAtmosData extra = CreateStandardTile(0, 1);
+    EXPECT_EQ(atmos_add_tile(state, &extra), -1);
+    EXPECT_EQ(atmos_get_tile_count(state), 4096);
+}
+
+TEST_F(IntegrationTest, LayoutGenerationTracksReallocation) {
+    uint32_t generation = atmos_get_layout_generation(state);
+    SetupLinearGrid(256);
+    EXPECT_EQ(atmos_get_layout_generation(state), generation);
+
+    TileAtmosData tile = CreateStandardTile(256, 0);
+    atmos_add_tile(state, &tile);
+    EXPECT_NE(atmos_get_layout_generation(state), generation);
+}
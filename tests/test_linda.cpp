@@ -311,4 +311,180 @@ TEST_F(LindaTest, ConservationOfMass) {
     }
     
     EXPECT_NEAR(finalTotal, newTotal, newTotal * 0.001f);
-}
\ No newline at end of file
+}
+
+TEST_F(LindaTest, SerialPassProcessesTilesActivatedDuringTick) {
+    SetupSquareGrid(8, 8);
+    config.monstermosEnabled = 0;
+
+    state->tiles[0].moles[GAS_OXYGEN] = 2000.0f;
+    atmos_add_active_tile(state, 0);
+
+    atmos_process(state, &config);
+
+    EXPECT_EQ(state->tiles[1].lastCycle, state->updateCounter);
+    EXPECT_EQ(state->tiles[2].lastCycle, state->updateCounter);
+}
+
+TEST_F(LindaTest, ParallelPassConservesMass) {
+    SetupSquareGrid(12, 12);
+
+    config.parallelLindaEnabled = 1;
+    ScopedWorkerThreads workers(4);
+
+    state->tiles[0].moles[GAS_OXYGEN] = 500.0f;
+    state->tiles[143].moles[GAS_NITROGEN] = 1000.0f;
+
+    float initialTotal = 0.0f;
+    for (int i = 0; i < 144; i++) {
+        initialTotal += GetTotalMoles(&state->tiles[i]);
+        atmos_add_active_tile(state, i);
+    }
+
+    for (int i = 0; i < 50; i++) {
+        state->updateCounter++;
+        atmos_process_active_tiles(state, &config);
+    }
+
+    float finalTotal = 0.0f;
+    for (int i = 0; i < 144; i++) {
+        finalTotal += GetTotalMoles(&state->tiles[i]);
+    }
+
+    EXPECT_NEAR(finalTotal, initialTotal, initialTotal * 0.001f);
+}
+
+TEST_F(LindaTest, ParallelPassEqualizes) {
+    SetupSquareGrid(5, 5);
+
+    config.parallelLindaEnabled = 1;
+    ScopedWorkerThreads workers(2);
+
+    state->tiles[12].moles[GAS_OXYGEN] = 200.0f;
+    state->tiles[12].moles[GAS_NITROGEN] = 800.0f;
+
+    atmos_add_active_tile(state, 12);
+
+    for (int i = 0; i < 100; i++) {
+        state->updateCounter++;
+        atmos_process_active_tiles(state, &config);
+    }
+
+    float minMoles = GetTotalMoles(&state->tiles[0]);
+    float maxMoles = minMoles;
+    for (int i = 1; i < 25; i++) {
+        float moles = GetTotalMoles(&state->tiles[i]);
+        if (moles < minMoles) minMoles = moles;
+        if (moles > maxMoles) maxMoles = moles;
+    }
+
+    EXPECT_LT(maxMoles - minMoles, maxMoles * 0.5f);
+}
+
+TEST_F(LindaTest, ParallelPassIndependentOfThreadCount) {
+    const int width = 40;
+    const int height = 40;
+    const int count = width * height;
+
+    GridAtmosState* grids[2];
+    int32_t threadCounts[2] = { 1, 4 };
+    ScopedWorkerThreads workers(1);
+
+    for (int g = 0; g < 2; g++) {
+        grids[g] = atmos_create_grid(count);
+        std::mt19937 rng(1234);
+        std::uniform_real_distribution<float> moles(10.0f, 400.0f);
+        std::uniform_real_distribution<float> temps(250.0f, 900.0f);
+
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                TileAtmosData tile = CreateStandardTile(x, y);
+                tile.moles[GAS_OXYGEN] = moles(rng);
+                tile.moles[GAS_NITROGEN] = moles(rng);
+                tile.temperature = temps(rng);
+                atmos_add_tile(grids[g], &tile);
+            }
+        }
+
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                int idx = y * width + x;
+                if (x < width - 1) {
+                    atmos_set_adjacency(grids[g], idx, ATMOS_DIR_EAST, idx + 1);
+                    atmos_set_adjacency(grids[g], idx + 1, ATMOS_DIR_WEST, idx);
+                }
+                if (y < height - 1) {
+                    atmos_set_adjacency(grids[g], idx, ATMOS_DIR_SOUTH, idx + width);
+                    atmos_set_adjacency(grids[g], idx + width, ATMOS_DIR_NORTH, idx);
+                }
+            }
+        }
+
+        for (int i = 0; i < count; i += 3)
+            atmos_add_active_tile(grids[g], i);
+
+        AtmosConfig parallelConfig = config;
+        parallelConfig.parallelLindaEnabled = 1;
+        parallelConfig.maxProcessTimeMicroseconds = 1000000;
+
+        atmos_set_worker_threads(threadCounts[g]);
+        for (int i = 0; i < 10; i++)
+            atmos_process(grids[g], &parallelConfig);
+    }
+
+    EXPECT_EQ(grids[0]->activeTileCount, grids[1]->activeTileCount);
+    for (int i = 0; i < count; i++) {
+        for (int gas = 0; gas < ATMOS_GAS_COUNT; gas++)
+            ASSERT_EQ(grids[0]->tiles[i].moles[gas], grids[1]->tiles[i].moles[gas]);
+        ASSERT_EQ(grids[0]->tiles[i].temperature, grids[1]->tiles[i].temperature);
+        ASSERT_EQ(grids[0]->tiles[i].excitedGroupId >= 0, grids[1]->tiles[i].excitedGroupId >= 0);
+    }
+
+    atmos_destroy_grid(grids[0]);
+    atmos_destroy_grid(grids[1]);
+}
+
+TEST_F(LindaTest, GridGasCountSelectsSharedGases) {
+    EXPECT_EQ(atmos_create_grid_ex(64, 16), nullptr);
+    EXPECT_EQ(atmos_get_gas_count(state), ATMOS_GAS_COUNT);
+
+    atmos_destroy_grid(state);
+    state = atmos_create_grid_ex(256, 12);
+    ASSERT_NE(state, nullptr);
+    EXPECT_EQ(atmos_get_gas_count(state), 12);
+
+    SetupLinearGrid(3);
+    state->tiles[0].moles[10] = 50.0f;
+    atmos_add_active_tile(state, 0);
+    process_cell(state, 0, &config);
+
+    EXPECT_GT(state->tiles[1].moles[10], 0.0f);
+    EXPECT_FLOAT_EQ(state->tiles[0].moles[10] + state->tiles[1].moles[10], 50.0f);
+
+    GridAtmosState* narrow = atmos_create_grid_ex(64, 8);
+    ASSERT_NE(narrow, nullptr);
+    TileAtmosData tile = CreateStandardTile(0, 0);
+    tile.moles[GAS_FREZON] = 5.0f;
+    int32_t index = atmos_add_tile(narrow, &tile);
+    EXPECT_FLOAT_EQ(atmos_get_tile(narrow, index)->moles[GAS_FREZON], 0.0f);
+    atmos_destroy_grid(narrow);
+}
+
+TEST_F(LindaTest, ArchiveClearsGasesPastGridGasCount) {
+    atmos_destroy_grid(state);
+    state = atmos_create_grid_ex(64, 8);
+    ASSERT_NE(state, nullptr);
+
+    SetupLinearGrid(2);
+    atmos_get_tiles_ptr(state)[0].moles[GAS_FREZON] = 5.0f;
+    atmos_add_active_tile(state, 0);
+    atmos_process_active_tiles(state, &config);
+
+    EXPECT_FLOAT_EQ(state->tiles[0].moles[GAS_FREZON], 0.0f);
+    EXPECT_FLOAT_EQ(state->tiles[0].molesArchived[GAS_FREZON], 0.0f);
+
+    state->tiles[1].moles[GAS_FREZON] = 5.0f;
+    atmos_archive_all(state);
+    EXPECT_FLOAT_EQ(state->tiles[1].moles[GAS_FREZON], 0.0f);
+    EXPECT_FLOAT_EQ(state->tiles[1].molesArchived[GAS_FREZON], 0.0f);
+}
@@ -1,4 +1,5 @@
 #include "test_common.h"
+#include <thread>
 
 class MonstermosTest : public AtmosTestFixture {
 protected:
@@ -134,6 +135,50 @@ TEST_F(MonstermosTest, ExplosiveDepressurizeSetsPressureDifference) {
     EXPECT_TRUE(foundPressureDiff);
 }
 
+TEST_F(MonstermosTest, ExplosiveDepressurizeReplaysCachedFlowField) {
+    GridAtmosState* grids[2] = { state, atmos_create_grid(16) };
+    AtmosConfig configs[2] = { config, config };
+
+    for (int g = 0; g < 2; g++) {
+        for (int y = 0; y < 3; y++) {
+            for (int x = 0; x < 4; x++) {
+                TileAtmosData tile = CreateStandardTile(x, y);
+                atmos_add_tile(grids[g], &tile);
+            }
+        }
+        TileAtmosData spaceTile = CreateSpaceTile(4, 1);
+        atmos_add_tile(grids[g], &spaceTile);
+        atmos_build_adjacency(grids[g]);
+    }
+
+    for (int tick = 0; tick < 3; tick++) {
+        configs[1].constants.monstermosHardTileLimit = 2000 + tick;
+        for (int g = 0; g < 2; g++) {
+            grids[g]->updateCounter++;
+            atmos_explosive_depressurize(grids[g], 0, &configs[g]);
+        }
+    }
+
+    for (int i = 0; i < 12; i++) {
+        EXPECT_EQ(GetTotalMoles(&grids[0]->tiles[i]), GetTotalMoles(&grids[1]->tiles[i]));
+        EXPECT_EQ(grids[0]->tiles[i].pressureDifference, grids[1]->tiles[i].pressureDifference);
+    }
+
+    AtmosStats stats[2];
+    atmos_get_stats(grids[0], &stats[0], 0);
+    atmos_get_stats(grids[1], &stats[1], 0);
+    EXPECT_EQ(stats[0].depressurizeCacheHits, 2);
+    EXPECT_EQ(stats[1].depressurizeCacheHits, 0);
+
+    atmos_set_adjacency(state, 7, ATMOS_DIR_EAST, -1);
+    state->updateCounter++;
+    atmos_explosive_depressurize(state, 0, &config);
+    atmos_get_stats(state, &stats[0], 0);
+    EXPECT_EQ(stats[0].depressurizeCacheHits, 2);
+
+    atmos_destroy_grid(grids[1]);
+}
+
 TEST_F(MonstermosTest, ExplosiveDepressurizeDisabled) {
     config.spacingEnabled = 0;
     
@@ -229,6 +274,185 @@ TEST_F(MonstermosTest, DisconnectedTilesNotAffected) {
     EXPECT_NEAR(GetTotalMoles(&state->tiles[disconnectedIdx]), disconnectedMoles, 0.01f);
 }
 
+TEST_F(MonstermosTest, ZoneCacheReusedUntilTopologyChanges) {
+    SetupLinearGrid(6);
+    AtmosStats stats;
+
+    for (int cycle = 0; cycle < 2; cycle++) {
+        state->tiles[0].moles[GAS_OXYGEN] = 500.0f;
+        state->updateCounter++;
+        atmos_equalize_pressure_zone(state, 0, &config);
+    }
+
+    atmos_get_stats(state, &stats, 0);
+    EXPECT_EQ(stats.monstermosZones, 2);
+    EXPECT_EQ(stats.monstermosZoneCacheHits, 1);
+
+    atmos_set_adjacency(state, 2, ATMOS_DIR_EAST, -1);
+    atmos_set_adjacency(state, 3, ATMOS_DIR_WEST, -1);
+    float farMoles = GetTotalMoles(&state->tiles[5]);
+
+    state->tiles[0].moles[GAS_OXYGEN] = 500.0f;
+    state->updateCounter++;
+    atmos_equalize_pressure_zone(state, 0, &config);
+
+    atmos_get_stats(state, &stats, 0);
+    EXPECT_EQ(stats.monstermosZoneCacheHits, 1);
+    EXPECT_NEAR(GetTotalMoles(&state->tiles[5]), farMoles, 0.01f);
+
+    TileAtmosData tile = state->tiles[4];
+    tile.moles[GAS_OXYGEN] += 1.0f;
+    state->tiles[0].moles[GAS_OXYGEN] = 500.0f;
+    state->updateCounter++;
+    atmos_update_tile(state, 4, &tile);
+    atmos_equalize_pressure_zone(state, 0, &config);
+
+    atmos_get_stats(state, &stats, 0);
+    EXPECT_EQ(stats.monstermosZoneCacheHits, 2);
+}
+
+TEST_F(MonstermosTest, ZoneCacheSharedByMembersAndValidated) {
+    SetupLinearGrid(6);
+    AtmosStats stats;
+
+    state->tiles[0].moles[GAS_OXYGEN] = 500.0f;
+    state->updateCounter++;
+    atmos_equalize_pressure_zone(state, 0, &config);
+
+    state->tiles[5].moles[GAS_OXYGEN] = 500.0f;
+    state->updateCounter++;
+    atmos_equalize_pressure_zone(state, 5, &config);
+
+    atmos_get_stats(state, &stats, 0);
+    EXPECT_EQ(stats.monstermosZoneCacheHits, 1);
+    EXPECT_NEAR(GetTotalMoles(&state->tiles[0]), GetTotalMoles(&state->tiles[5]), 0.01f);
+
+    TileAtmosData* tiles = atmos_get_tiles_ptr(state);
+    tiles[2].adjacentBits &= ~(1 << ATMOS_DIR_EAST);
+    tiles[3].adjacentBits &= ~(1 << ATMOS_DIR_WEST);
+    float farMoles = GetTotalMoles(&state->tiles[5]);
+
+    state->tiles[0].moles[GAS_OXYGEN] = 500.0f;
+    state->updateCounter++;
+    atmos_equalize_pressure_zone(state, 0, &config);
+
+    atmos_get_stats(state, &stats, 0);
+    EXPECT_EQ(stats.monstermosZoneCacheHits, 1);
+    EXPECT_NEAR(GetTotalMoles(&state->tiles[5]), farMoles, 0.01f);
+}
+
+TEST_F(MonstermosTest, CoarseEqualizationSpansWholeZone) {
+    const int width = 64;
+    const int height = 48;
+    SetupSquareGrid(width, height);
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width / 4; x++) {
+            state->tiles[y * width + x].moles[GAS_NITROGEN] += 200.0f;
+        }
+    }
+
+    float totalBefore = 0.0f;
+    for (int i = 0; i < width * height; i++)
+        totalBefore += GetTotalMoles(&state->tiles[i]);
+
+    config.monstermosCoarseEnabled = 1;
+    state->updateCounter++;
+    atmos_equalize_pressure_zone(state, width / 4 - 1, &config);
+
+    AtmosStats stats;
+    atmos_get_stats(state, &stats, 0);
+    EXPECT_EQ(stats.monstermosCoarseZones, 1);
+    EXPECT_EQ(stats.monstermosLargestZone, width * height);
+
+    float totalAfter = 0.0f;
+    float expected = totalBefore / (width * height);
+    for (int i = 0; i < width * height; i++) {
+        float moles = GetTotalMoles(&state->tiles[i]);
+        totalAfter += moles;
+        EXPECT_NEAR(moles, expected, expected * 0.001f);
+    }
+
+    EXPECT_NEAR(totalAfter, totalBefore, totalBefore * 0.001f);
+    EXPECT_GT(state->highPressureTileCount, 0);
+}
+
+TEST_F(MonstermosTest, CoarseBlocksDoNotMixAcrossWalls) {
+    const int width = 8;
+    const int height = 12;
+    SetupSquareGrid(width, height);
+
+    for (int y = 0; y < 10; y++) {
+        atmos_set_adjacency(state, y * width + 3, ATMOS_DIR_EAST, -1);
+        atmos_set_adjacency(state, y * width + 4, ATMOS_DIR_WEST, -1);
+    }
+
+    for (int y = 0; y < 8; y++) {
+        for (int x = 0; x < 4; x++) {
+            TileAtmosData* tile = &state->tiles[y * width + x];
+            float moles = GetTotalMoles(tile);
+            memset(tile->moles, 0, sizeof(tile->moles));
+            tile->moles[GAS_PLASMA] = moles;
+        }
+    }
+    state->tiles[11 * width].moles[GAS_OXYGEN] += 20.0f;
+
+    config.monstermosCoarseEnabled = 1;
+    config.constants.monstermosTileLimit = 32;
+    state->updateCounter++;
+    atmos_equalize_pressure_zone(state, 11 * width, &config);
+
+    AtmosStats stats;
+    atmos_get_stats(state, &stats, 0);
+    EXPECT_EQ(stats.monstermosCoarseZones, 1);
+    EXPECT_GT(state->tiles[3].moles[GAS_PLASMA], 0.0f);
+    EXPECT_FLOAT_EQ(state->tiles[4].moles[GAS_PLASMA], 0.0f);
+    EXPECT_NEAR(GetTotalMoles(&state->tiles[4]), GetTotalMoles(&state->tiles[3]), 0.01f);
+}
+
+TEST_F(MonstermosTest, SlowPathSettlesScatteredGivers) {
+    const int width = 14;
+    SetupSquareGrid(width, width);
+
+    const int givers[5] = { 0, 13, 97, 182, 195 };
+    for (int g : givers)
+        state->tiles[g].moles[GAS_NITROGEN] += 300.0f;
+
+    float totalBefore = 0.0f;
+    for (int i = 0; i < width * width; i++)
+        totalBefore += GetTotalMoles(&state->tiles[i]);
+
+    state->updateCounter++;
+    atmos_equalize_pressure_zone(state, 0, &config);
+
+    float expected = totalBefore / (width * width);
+    float totalAfter = 0.0f;
+    for (int i = 0; i < width * width; i++) {
+        float moles = GetTotalMoles(&state->tiles[i]);
+        totalAfter += moles;
+        EXPECT_NEAR(moles, expected, expected * 0.001f);
+    }
+
+    EXPECT_NEAR(totalAfter, totalBefore, totalBefore * 0.001f);
+}
+
+TEST_F(MonstermosTest, SlowPathRoutesPastExhaustedGiver) {
+    SetupLinearGrid(12);
+
+    for (int i = 0; i < 12; i++) {
+        state->tiles[i].moles[GAS_NITROGEN] = 0.0f;
+        state->tiles[i].moles[GAS_OXYGEN] = i < 7 ? 50.0f : 90.0f;
+    }
+    state->tiles[7].moles[GAS_OXYGEN] = 110.0f;
+    state->tiles[8].moles[GAS_OXYGEN] = 470.0f;
+
+    state->updateCounter++;
+    atmos_equalize_pressure_zone(state, 7, &config);
+
+    for (int i = 0; i < 12; i++)
+        EXPECT_NEAR(GetTotalMoles(&state->tiles[i]), 100.0f, 0.1f);
+}
+
 TEST_F(MonstermosTest, EqualizationConvergence) {
     SetupLinearGrid(10);
     
@@ -328,4 +552,80 @@ TEST_F(MonstermosTest, SpacingMaxWind) {
     for (int i = 0; i < 3; i++) {
         EXPECT_LE(state->tiles[i].pressureDifference, config.spacingMaxWind * 2.0f);
     }
-}
\ No newline at end of file
+}
+TEST_F(MonstermosTest, HardTileLimitAboveDefault) {
+    SetupSquareGrid(80, 80);
+    config.constants.monstermosHardTileLimit = 6000;
+    config.constants.monstermosTileLimit = 6000;
+
+    state->tiles[3240].moles[GAS_OXYGEN] = 50000.0f;
+
+    float totalBefore = 0.0f;
+    for (int i = 0; i < state->tileCount; i++)
+        totalBefore += GetTotalMoles(&state->tiles[i]);
+
+    state->updateCounter++;
+    atmos_equalize_pressure_zone(state, 3240, &config);
+
+    float totalAfter = 0.0f;
+    for (int i = 0; i < state->tileCount; i++)
+        totalAfter += GetTotalMoles(&state->tiles[i]);
+
+    EXPECT_NEAR(totalAfter, totalBefore, totalBefore * 0.01f);
+    EXPECT_LT(state->tiles[3240].moles[GAS_OXYGEN], 50000.0f);
+}
+
+TEST_F(MonstermosTest, ConcurrentGridsMatchSerial) {
+    const int width = 40;
+    const int count = width * width;
+
+    auto buildGrid = [&]() {
+        GridAtmosState* grid = atmos_create_grid(count);
+        for (int y = 0; y < width; y++) {
+            for (int x = 0; x < width; x++) {
+                TileAtmosData tile = CreateStandardTile(x, y);
+                tile.moles[GAS_OXYGEN] = 10.0f + (float)((x * 7 + y * 13) % 50);
+                atmos_add_tile(grid, &tile);
+            }
+        }
+        for (int y = 0; y < width; y++) {
+            for (int x = 0; x < width; x++) {
+                int idx = y * width + x;
+                if (x < width - 1) {
+                    atmos_set_adjacency(grid, idx, ATMOS_DIR_EAST, idx + 1);
+                    atmos_set_adjacency(grid, idx + 1, ATMOS_DIR_WEST, idx);
+                }
+                if (y < width - 1) {
+                    atmos_set_adjacency(grid, idx, ATMOS_DIR_SOUTH, idx + width);
+                    atmos_set_adjacency(grid, idx + width, ATMOS_DIR_NORTH, idx);
+                }
+            }
+        }
+        return grid;
+    };
+
+    auto runGrid = [&](GridAtmosState* grid) {
+        for (int cycle = 0; cycle < 20; cycle++) {
+            grid->updateCounter++;
+            for (int i = 0; i < count; i += 37)
+                equalize_pressure_in_zone(grid, i, &config);
+        }
+    };
+
+    GridAtmosState* reference = buildGrid();
+    runGrid(reference);
+
+    GridAtmosState* grids[2] = { buildGrid(), buildGrid() };
+    std::thread worker([&]() { runGrid(grids[1]); });
+    runGrid(grids[0]);
+    worker.join();
+
+    for (int g = 0; g < 2; g++) {
+        for (int i = 0; i < count; i++) {
+            for (int gas = 0; gas < ATMOS_GAS_COUNT; gas++)
+                ASSERT_EQ(grids[g]->tiles[i].moles[gas], reference->tiles[i].moles[gas]);
+        }
+        atmos_destroy_grid(grids[g]);
+    }
+    atmos_destroy_grid(reference);
+}
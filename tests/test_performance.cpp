@@ -1,6 +1,8 @@
 #include "test_common.h"
 #include <iostream>
 #include <iomanip>
+#include <string>
+#include <vector>
 
 class PerformanceTest : public AtmosTestFixture {
 protected:
@@ -335,6 +337,103 @@ TEST_F(PerformanceTest, ExcitedGroupProcessing) {
     EXPECT_LT(elapsed / iterations, 20.0);
 }
 
+static int benchmark_mole_delta_compare(const void* a, const void* b) {
+    TileAtmosData* ta = *(TileAtmosData**)a;
+    TileAtmosData* tb = *(TileAtmosData**)b;
+    if (ta->moleDelta < tb->moleDelta) return -1;
+    if (ta->moleDelta > tb->moleDelta) return 1;
+    return 0;
+}
+
+TEST_F(PerformanceTest, MoleDeltaSortVsQsort) {
+    config.constants.monstermosHardTileLimit = 2000;
+    MonstermosScratch* scratch = ensure_monstermos_scratch(state, &config);
+    ASSERT_NE(scratch, nullptr);
+
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> dist(-500.0f, 500.0f);
+    const int zoneSizes[2] = { 200, 2000 };
+
+    for (int zoneSize : zoneSizes) {
+        std::vector<TileAtmosData> tiles(zoneSize);
+        std::vector<TileAtmosData*> source(zoneSize);
+        std::vector<TileAtmosData*> sorted(zoneSize);
+        for (int i = 0; i < zoneSize; i++) {
+            tiles[i].moleDelta = dist(rng);
+            source[i] = &tiles[i];
+        }
+
+        const int iterations = 200000 / zoneSize;
+        PerformanceTimer timer;
+
+        timer.Start();
+        for (int i = 0; i < iterations; i++) {
+            sorted = source;
+            qsort(sorted.data(), zoneSize, sizeof(TileAtmosData*), benchmark_mole_delta_compare);
+        }
+        PrintResult("MoleDeltaSort qsort (" + std::to_string(zoneSize) + ")", timer.ElapsedMs(), iterations);
+
+        timer.Start();
+        for (int i = 0; i < iterations; i++) {
+            sorted = source;
+            sort_tiles_by_mole_delta(sorted.data(), zoneSize, scratch);
+        }
+        PrintResult("MoleDeltaSort radix (" + std::to_string(zoneSize) + ")", timer.ElapsedMs(), iterations);
+
+        for (int i = 1; i < zoneSize; i++)
+            ASSERT_LE(sorted[i - 1]->moleDelta, sorted[i]->moleDelta);
+    }
+}
+
+TEST_F(PerformanceTest, EqualizeScatteredGiversZone) {
+    SetupLargeGrid(40, 50);
+    config.constants.monstermosTileLimit = 2000;
+
+    const int iterations = 20;
+    PerformanceTimer timer;
+    double elapsed = 0.0;
+
+    for (int i = 0; i < iterations; i++) {
+        for (int t = 0; t < 2000; t++) {
+            TileAtmosData tile = CreateStandardTile(t % 40, t / 40);
+            if (t % 200 == 7)
+                tile.moles[GAS_NITROGEN] += 2000.0f;
+            memcpy(state->tiles[t].moles, tile.moles, sizeof(tile.moles));
+        }
+        state->updateCounter++;
+
+        timer.Start();
+        atmos_equalize_pressure_zone(state, 7, &config);
+        elapsed += timer.ElapsedMs();
+    }
+
+    PrintResult("EqualizeScatteredGivers (2000 tiles, 10 givers)", elapsed, iterations);
+    EXPECT_LT(elapsed / iterations, 50.0);
+}
+
+TEST_F(PerformanceTest, CoarseEqualizePressureZone) {
+    SetupLargeGrid(160, 125);
+    config.monstermosCoarseEnabled = 1;
+
+    const int iterations = 20;
+    PerformanceTimer timer;
+
+    timer.Start();
+    for (int i = 0; i < iterations; i++) {
+        state->tiles[0].moles[GAS_OXYGEN] += 500.0f;
+        state->updateCounter++;
+        atmos_equalize_pressure_zone(state, 0, &config);
+    }
+    double elapsed = timer.ElapsedMs();
+
+    PrintResult("CoarseEqualizePressureZone (160x125)", elapsed, iterations);
+
+    AtmosStats stats;
+    atmos_get_stats(state, &stats, 0);
+    EXPECT_EQ(stats.monstermosCoarseZones, iterations);
+    EXPECT_LT(elapsed / iterations, 50.0);
+}
+
 TEST_F(PerformanceTest, GridCreationAndDestruction) {
     const int iterations = 100;
     PerformanceTimer timer;
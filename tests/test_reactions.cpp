@@ -1,4 +1,7 @@
 #include "test_common.h"
+#include <atomic>
+#include <vector>
+#include <string.h>
 
 class ReactionTest : public AtmosTestFixture {};
 
@@ -583,4 +586,109 @@ TEST_F(ReactionTest, TritiumFireConsumesCorrectRatio) {
     if (tritiumBurned > 0) {
         EXPECT_NEAR(oxygenBurned / tritiumBurned, config.constants.tritiumBurnOxyFactor, 1.0f);
     }
-}
\ No newline at end of file
+}
+TEST_F(ReactionTest, PlainAirTileIsRejectedByPrefilter) {
+    TileAtmosData tile = CreateStandardTile(0, 0);
+    tile.temperature = 5000.0f;
+    TileAtmosData before = tile;
+
+    uint32_t reactedMask = 0xFFFFFFFFu;
+    EXPECT_EQ(react_tracked(&tile, &config, &reactedMask), 0);
+    EXPECT_EQ(reactedMask, 0u);
+    EXPECT_EQ(memcmp(&tile, &before, sizeof(TileAtmosData)), 0);
+}
+
+TEST_F(ReactionTest, RegisteredReactionRunsThroughReactionPath) {
+    AtmosReactionDefinition definition = {};
+    definition.reactants[GAS_CO2] = 2.0f;
+    definition.reactants[GAS_NITROGEN] = 1.0f;
+    definition.products[GAS_N2O] = 1.0f;
+    definition.minimumTemperature = 400.0f;
+    definition.maximumTemperature = 2000.0f;
+    definition.rateCoefficient = 0.1f;
+    definition.energyReleased = 5000.0f;
+    definition.rateFormula = ATMOS_REACTION_RATE_LIMITING;
+
+    int32_t id = atmos_register_reaction(&definition);
+    ASSERT_EQ(id, ATMOS_REACTION_TYPE_COUNT);
+    EXPECT_EQ(atmos_get_reaction_count(), ATMOS_REACTION_TYPE_COUNT + 1);
+
+    TileAtmosData tile = {};
+    tile.moles[GAS_CO2] = 40.0f;
+    tile.moles[GAS_NITROGEN] = 10.0f;
+    tile.temperature = 500.0f;
+
+    uint32_t reactedMask = 0;
+    EXPECT_EQ(react_tracked(&tile, &config, &reactedMask), 1);
+    EXPECT_EQ(reactedMask, 1u << id);
+    EXPECT_FLOAT_EQ(tile.moles[GAS_NITROGEN], 9.0f);
+    EXPECT_FLOAT_EQ(tile.moles[GAS_CO2], 38.0f);
+    EXPECT_FLOAT_EQ(tile.moles[GAS_N2O], 1.0f);
+    EXPECT_GT(tile.temperature, 500.0f);
+
+    TileAtmosData cold = {};
+    cold.moles[GAS_CO2] = 40.0f;
+    cold.moles[GAS_NITROGEN] = 10.0f;
+    cold.temperature = 300.0f;
+    EXPECT_EQ(react_impl(&cold, &config), 0);
+
+    AtmosReactionDefinition invalid = definition;
+    invalid.reactants[GAS_CO2] = -1.0f;
+    EXPECT_EQ(atmos_register_reaction(&invalid), -1);
+
+    atmos_reset_reactions();
+    EXPECT_EQ(atmos_get_reaction_count(), ATMOS_REACTION_TYPE_COUNT);
+    EXPECT_EQ(react_impl(&cold, &config), 0);
+}
+
+TEST_F(ReactionTest, RegisteredReactionPriorityRunsBeforeBuiltins) {
+    AtmosReactionDefinition definition = {};
+    definition.reactants[GAS_PLASMA] = 1.0f;
+    definition.products[GAS_TRITIUM] = 1.0f;
+    definition.minimumTemperature = 0.0f;
+    definition.maximumTemperature = 100000.0f;
+    definition.rateCoefficient = 1.0f;
+    definition.rateFormula = ATMOS_REACTION_RATE_LIMITING;
+    definition.priority = 1;
+
+    int32_t id = atmos_register_reaction(&definition);
+    ASSERT_GE(id, 0);
+
+    TileAtmosData tile = {};
+    tile.moles[GAS_PLASMA] = 10.0f;
+    tile.moles[GAS_OXYGEN] = 30.0f;
+    tile.temperature = config.constants.plasmaUpperTemperature + 100.0f;
+
+    uint32_t reactedMask = 0;
+    react_tracked(&tile, &config, &reactedMask);
+    atmos_reset_reactions();
+
+    EXPECT_TRUE(reactedMask & (1u << id));
+    EXPECT_FALSE(reactedMask & (1u << ATMOS_REACTION_PLASMA_FIRE));
+    EXPECT_FLOAT_EQ(tile.moles[GAS_PLASMA], 0.0f);
+}
+
+static void register_reaction_job(void* context, int32_t begin, int32_t end) {
+    std::atomic<int32_t>* accepted = (std::atomic<int32_t>*)context;
+    AtmosReactionDefinition definition = {};
+    definition.reactants[GAS_PLASMA] = 1.0f;
+    definition.maximumTemperature = 1000.0f;
+    definition.rateCoefficient = 1.0f;
+    definition.rateFormula = ATMOS_REACTION_RATE_LIMITING;
+    for (int32_t i = begin; i < end; i++) {
+        if (atmos_register_reaction(&definition) >= 0)
+            (*accepted)++;
+        *accepted += atmos_reset_reactions();
+    }
+}
+
+TEST_F(ReactionTest, RegistrationRejectedWhilePoolBusy) {
+    ScopedWorkerThreads workers(2);
+
+    std::atomic<int32_t> accepted(0);
+    thread_pool_parallel_for(8, 1, register_reaction_job, &accepted);
+
+    EXPECT_EQ(accepted.load(), 0);
+    EXPECT_EQ(atmos_get_reaction_count(), ATMOS_REACTION_TYPE_COUNT);
+    EXPECT_EQ(atmos_reset_reactions(), 1);
+}
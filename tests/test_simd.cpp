@@ -1,5 +1,6 @@
 #include "test_common.h"
 #include "atmos_simd.h"
+#include <vector>
 
 class SIMDTest : public ::testing::Test {};
 
@@ -254,4 +255,116 @@ TEST_F(SIMDTest, MixedValues) {
     float expected = -1 - 4 - 9 - 16 - 25 - 36 - 49 - 64;
     
     EXPECT_NEAR(dot, expected, 0.001f);
-}
\ No newline at end of file
+}
+TEST_F(SIMDTest, ReportedLevelMatchesSelectedKernels) {
+    EXPECT_EQ(atmos_get_simd_level(), atmos_kernel_table()->simdLevel);
+    EXPECT_LE(atmos_get_simd_level(), detect_cpu_simd_level());
+}
+
+TEST_F(SIMDTest, DispatchedKernelsAgreeAcrossLevels) {
+    AtmosConfig config;
+    atmos_config_init_default(&config);
+
+    TileAtmosData a = {};
+    TileAtmosData b = {};
+    for (int g = 0; g < ATMOS_GAS_COUNT; g++) {
+        a.moles[g] = a.molesArchived[g] = 10.0f + g * 3.0f;
+        b.moles[g] = b.molesArchived[g] = 2.0f + g * 0.5f;
+    }
+    a.temperature = a.temperatureArchived = 500.0f;
+    b.temperature = b.temperatureArchived = 250.0f;
+
+    const AtmosKernelTable* baseline = kernel_table_sse2();
+    TileAtmosData expectA = a, expectB = b;
+    baseline->share(&expectA, &expectB, 4, &config);
+
+    for (uint32_t level = ATMOS_SIMD_SSE2; level <= detect_cpu_simd_level(); level++) {
+        const AtmosKernelTable* table = select_kernel_table(level);
+        EXPECT_EQ(table->simdLevel, level);
+
+        EXPECT_NEAR(table->heatCapacity(a.moles, config.gasSpecificHeats, false),
+                    baseline->heatCapacity(a.moles, config.gasSpecificHeats, false), 1e-2f);
+
+        TileAtmosData ra = a, rb = b;
+        table->share(&ra, &rb, 4, &config);
+        EXPECT_NEAR(ra.temperature, expectA.temperature, 1e-2f);
+        EXPECT_NEAR(rb.temperature, expectB.temperature, 1e-2f);
+        for (int g = 0; g < ATMOS_GAS_COUNT; g++)
+            EXPECT_NEAR(ra.moles[g], expectA.moles[g], 1e-4f);
+    }
+}
+
+TEST_F(SIMDTest, DispatchedGroupBreakdownMatchesScalarAverage) {
+    AtmosConfig config;
+    atmos_config_init_default(&config);
+
+    const int count = 1000;
+    std::vector<TileAtmosData> source(count);
+    std::vector<int32_t> next(count);
+
+    for (int i = 0; i < count; i++) {
+        TileAtmosData& tile = source[i];
+        tile = {};
+        for (int g = 0; g < ATMOS_GAS_COUNT; g++)
+            tile.moles[g] = (float)((i * 7 + g * 13) % 50);
+        tile.temperature = 200.0f + (float)(i % 300);
+        if (i % 97 == 0)
+            tile.flags = TILE_FLAG_IMMUTABLE;
+        next[i] = i + 1 < count ? i + 1 : -1;
+    }
+
+    double heatCapacity = 0.0, energy = 0.0;
+    double moles[ATMOS_GAS_COUNT] = {0};
+    int mutableTiles = 0;
+    for (const TileAtmosData& tile : source) {
+        if (tile.flags & TILE_FLAG_IMMUTABLE) continue;
+        double hc = 0.0;
+        for (int g = 0; g < ATMOS_GAS_COUNT; g++) {
+            hc += tile.moles[g] * config.gasSpecificHeats[g];
+            moles[g] += tile.moles[g];
+        }
+        heatCapacity += hc;
+        energy += hc * tile.temperature;
+        mutableTiles++;
+    }
+
+    for (uint32_t level = ATMOS_SIMD_SSE2; level <= detect_cpu_simd_level(); level++) {
+        std::vector<TileAtmosData> tiles = source;
+        select_kernel_table(level)->groupBreakdown(tiles.data(), next.data(), 0, ATMOS_GAS_COUNT, &config);
+
+        for (int i = 0; i < count; i++) {
+            if (tiles[i].flags & TILE_FLAG_IMMUTABLE) {
+                EXPECT_EQ(tiles[i].temperature, source[i].temperature);
+                continue;
+            }
+            EXPECT_NEAR(tiles[i].temperature, energy / heatCapacity, 0.05);
+            for (int g = 0; g < ATMOS_GAS_COUNT; g++)
+                EXPECT_NEAR(tiles[i].moles[g], moles[g] / mutableTiles, 1e-2);
+        }
+    }
+}
+
+TEST_F(SIMDTest, DispatchedReactAgreesAcrossLevels) {
+    AtmosConfig config;
+    atmos_config_init_default(&config);
+
+    TileAtmosData source = {};
+    source.moles[GAS_PLASMA] = 10.0f;
+    source.moles[GAS_OXYGEN] = 20.0f;
+    source.temperature = 1000.0f;
+
+    TileAtmosData expected = source;
+    uint32_t expectedMask = 0;
+    int expectedResult = kernel_table_sse2()->react(&expected, &config, &expectedMask);
+    EXPECT_NE(expectedMask, 0u);
+
+    for (uint32_t level = ATMOS_SIMD_SSE2; level <= detect_cpu_simd_level(); level++) {
+        TileAtmosData tile = source;
+        uint32_t reactedMask = 0;
+        EXPECT_EQ(select_kernel_table(level)->react(&tile, &config, &reactedMask), expectedResult);
+        EXPECT_EQ(reactedMask, expectedMask);
+        EXPECT_NEAR(tile.temperature, expected.temperature, 0.05f);
+        for (int g = 0; g < ATMOS_GAS_COUNT; g++)
+            EXPECT_NEAR(tile.moles[g], expected.moles[g], 1e-4f);
+    }
+}